@@ -1,6 +1,9 @@
 #pragma once
 #include <cstddef>
+#include <cstring>
 #include <span>
+#include <stdexcept>
+#include <vector>
 
 namespace tlv
 {
@@ -26,4 +29,34 @@ struct Sizer
     void writeBytes(std::span<const std::byte> s) { n += s.size(); }
 };
 
+// appends to a caller-owned byte vector
+struct VectorWriter
+{
+    std::vector<std::byte>& out;
+
+    void writeBytes(std::span<const std::byte> s)
+    {
+        out.insert(out.end(), s.begin(), s.end());
+    }
+};
+
+// bounds-checked cursor over a borrowed byte range; running past the end
+// means the input is malformed, reported as std::runtime_error
+struct SpanReader
+{
+    std::span<const std::byte> in;
+    std::size_t pos{0};
+
+    void readExact(std::byte* p, std::size_t n)
+    {
+        if (n > in.size() - pos) {
+            throw std::runtime_error("SpanReader: truncated input");
+        }
+        if (n != 0) {
+            std::memcpy(p, in.data() + pos, n);
+        }
+        pos += n;
+    }
+};
+
 } // namespace tlv
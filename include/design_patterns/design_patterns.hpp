@@ -1,5 +1,7 @@
 #pragma once
 
+#include "enum_state_batch.hpp"
+#include "enum_state_machine.hpp"
 #include "memento/memento.hpp"
 #include "observer.hpp"
 #include "singleton.hpp"
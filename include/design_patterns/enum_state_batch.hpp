@@ -0,0 +1,238 @@
+// include/design_patterns/enum_state_batch.hpp
+#pragma once
+#include "enum_state_machine.hpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <latch>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+/*
+Structure-of-arrays engine for many instances of one EnumStateTable.
+
+Every instance shares the table bound as template argument; the engine only
+keeps one small integer per instance (its current state). update is done in
+bulk: instances are bucketed by current state (counting sort, rebuilt lazily
+after transitions) and each state's action runs over its contiguous bucket.
+
+    states_   [id] -> state               one byte per instance for <=256 states
+    order_    ids grouped by state        [ Red ids | Green ids | Yellow ids ]
+    offsets_  bucket boundaries in order_
+
+Contexts are not owned: updateAll(contexts) calls action(contexts[id]).
+
+The parallel overload splits buckets into chunks of `grain` instances and
+submits them to any executor exposing addJob(std::function<void()>)
+(e.g. WorkerPool), then waits for all of them. An executor that also has
+runOneJob() (WorkerPool) is helped while waiting, so the call may come from
+one of its own jobs. Actions of different instances then run concurrently,
+so they must only touch their own context.
+*/
+template <const auto& Table> class EnumStateBatch
+{
+public:
+    using TableType = std::remove_cvref_t<decltype(Table)>;
+    using State = typename TableType::State;
+    using Context = typename TableType::Context;
+    using InstanceId = std::uint32_t;
+
+    static constexpr std::size_t kStateCount = TableType::kStateCount;
+
+    void reserve(std::size_t n)
+    {
+        states_.reserve(n);
+        order_.reserve(n);
+    }
+
+    InstanceId add(State initial)
+    {
+        auto idx = static_cast<StorageType>(TableType::indexOf(initial));
+        states_.push_back(idx);
+        dirty_ = true;
+        return static_cast<InstanceId>(states_.size() - 1);
+    }
+
+    std::size_t size() const { return states_.size(); }
+
+    State state(InstanceId id) const
+    {
+        return static_cast<State>(states_.at(id));
+    }
+
+    // same contract as EnumStateMachine::transitionTo, for one instance
+    void transitionTo(InstanceId id, State state, Context& ctx)
+    {
+        auto& current = states_.at(id);
+        const std::size_t to = TableType::indexOf(state);
+        if (to == current) {
+            return; // No transition needed
+        }
+        auto cb = Table.transitions[current][to];
+        if (cb == nullptr) {
+            throw std::runtime_error("No transition defined to target state");
+        }
+        cb(ctx);
+        current = static_cast<StorageType>(to);
+        dirty_ = true;
+    }
+
+    std::size_t countIn(State state)
+    {
+        _regroup();
+        const std::size_t s = TableType::indexOf(state);
+        return offsets_[s + 1] - offsets_[s];
+    }
+
+    void updateAll(std::span<Context> contexts)
+    {
+        _prepareUpdate(contexts);
+        for (std::size_t s = 0; s < kStateCount; ++s) {
+            _runRange(s, offsets_[s], offsets_[s + 1], contexts);
+        }
+    }
+
+    template <class Executor>
+    void updateAll(std::span<Context> contexts,
+                   Executor& executor,
+                   std::size_t grain = 1024)
+    {
+        _prepareUpdate(contexts);
+        if (grain == 0) {
+            grain = 1;
+        }
+
+        std::size_t jobs = 0;
+        for (std::size_t s = 0; s < kStateCount; ++s) {
+            const std::size_t n = offsets_[s + 1] - offsets_[s];
+            jobs += (n + grain - 1) / grain;
+        }
+        if (jobs == 0) {
+            return;
+        }
+
+        std::latch done(static_cast<std::ptrdiff_t>(jobs));
+        std::exception_ptr error;
+        std::mutex errorMutex;
+
+        std::size_t submitted = 0;
+        try {
+            for (std::size_t s = 0; s < kStateCount; ++s) {
+                for (std::size_t b = offsets_[s]; b < offsets_[s + 1];
+                     b += grain) {
+                    const std::size_t e = std::min(b + grain, offsets_[s + 1]);
+                    executor.addJob([&, s, b, e]() {
+                        try {
+                            _runRange(s, b, e, contexts);
+                        }
+                        catch (...) {
+                            // keep the first failure, rethrown on the caller
+                            std::lock_guard<std::mutex> lock(errorMutex);
+                            if (!error) {
+                                error = std::current_exception();
+                            }
+                        }
+                        done.count_down();
+                    });
+                    ++submitted;
+                }
+            }
+        }
+        catch (...) {
+            // queued jobs reference this frame: let them finish first
+            done.count_down(static_cast<std::ptrdiff_t>(jobs - submitted));
+            _wait(done, executor);
+            throw;
+        }
+        _wait(done, executor);
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+private:
+    // helps an executor that can run its queued jobs (WorkerPool), so a
+    // call from inside one of its jobs cannot block every worker
+    template <class Executor>
+    static void _wait(std::latch& done, Executor& executor)
+    {
+        if constexpr (requires { executor.runOneJob(); }) {
+            while (!done.try_wait()) {
+                if (!executor.runOneJob()) {
+                    std::this_thread::yield();
+                }
+            }
+        }
+        else {
+            done.wait();
+        }
+    }
+
+    using StorageType = std::conditional_t<
+        (kStateCount <= 0x100),
+        std::uint8_t,
+        std::conditional_t<(kStateCount <= 0x10000),
+                           std::uint16_t,
+                           std::uint32_t>>;
+
+    void _regroup()
+    {
+        if (!dirty_) {
+            return;
+        }
+        // counting sort of instance ids by their current state
+        offsets_.fill(0);
+        for (auto s : states_) {
+            ++offsets_[s + 1];
+        }
+        for (std::size_t s = 0; s < kStateCount; ++s) {
+            offsets_[s + 1] += offsets_[s];
+        }
+        std::array<std::size_t, kStateCount> cursor{};
+        std::copy(offsets_.begin(), offsets_.end() - 1, cursor.begin());
+
+        order_.resize(states_.size());
+        for (std::size_t id = 0; id < states_.size(); ++id) {
+            order_[cursor[states_[id]]++] = static_cast<InstanceId>(id);
+        }
+        dirty_ = false;
+    }
+
+    void _prepareUpdate(std::span<Context> contexts)
+    {
+        if (contexts.size() != states_.size()) {
+            throw std::invalid_argument(
+                "Context count does not match instance count");
+        }
+        _regroup();
+        // fail before running anything, like StateMachine::update()
+        for (std::size_t s = 0; s < kStateCount; ++s) {
+            if (offsets_[s + 1] != offsets_[s] && Table.actions[s] == nullptr) {
+                throw std::runtime_error(
+                    "No action defined for current state");
+            }
+        }
+    }
+
+    void _runRange(std::size_t state,
+                   std::size_t begin,
+                   std::size_t end,
+                   std::span<Context> contexts) const
+    {
+        auto action = Table.actions[state];
+        for (std::size_t i = begin; i < end; ++i) {
+            action(contexts[order_[i]]);
+        }
+    }
+
+private:
+    std::vector<StorageType> states_;
+    std::vector<InstanceId> order_;
+    std::array<std::size_t, kStateCount + 1> offsets_{};
+    bool dirty_{false};
+};
@@ -0,0 +1,139 @@
+// include/design_patterns/enum_state_machine.hpp
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+
+/*
+Compile-time variant of StateMachine for enum states.
+
+StateMachine<TState> resolves every transition through two hash lookups and a
+set lookup. When the states are a dense enum known at compile time, the whole
+definition fits into flat tables:
+
+    actions[state]            -> void (*)(TContext&)
+    transitions[from][to]     -> void (*)(TContext&)   (nullptr = not allowed)
+
+The table is built in a constant expression (captureless lambdas decay to
+function pointers) and bound to the machine as a template argument, so a
+transition is a bounds check, an array index and a call. A machine instance is
+only its current state; the callbacks receive the per-entity context as an
+argument instead of capturing it.
+
+    constexpr auto kLight = EnumStateTable<Light, 3, Counters>{}
+        .action(Light::Red, [](Counters& c) { c.red++; })
+        .transition(Light::Red, Light::Green, [](Counters& c) { c.calls++; });
+
+    EnumStateMachine<kLight> sm(Light::Red);
+    sm.transitionTo(Light::Green, counters);
+    sm.update(counters);
+
+Defining the same action/transition twice or using a state outside [0, N)
+throws inside the constant expression, which turns it into a compile error.
+*/
+template <class TState, std::size_t N, class TContext> struct EnumStateTable
+{
+    using State = TState;
+    using Context = TContext;
+    using Callback = void (*)(TContext&);
+
+    static constexpr std::size_t kStateCount = N;
+
+    std::array<Callback, N> actions{};
+    std::array<std::array<Callback, N>, N> transitions{};
+
+    constexpr EnumStateTable action(TState state, Callback cb) const
+    {
+        EnumStateTable copy = *this;
+        auto& slot = copy.actions[indexOf(state)];
+        if (slot != nullptr) {
+            throw std::runtime_error("Action already exists for this state");
+        }
+        slot = cb;
+        return copy;
+    }
+
+    constexpr EnumStateTable
+    transition(TState startState, TState finalState, Callback cb) const
+    {
+        EnumStateTable copy = *this;
+        auto& slot =
+            copy.transitions[indexOf(startState)][indexOf(finalState)];
+        if (slot != nullptr) {
+            throw std::runtime_error("Transition already exists");
+        }
+        slot = cb;
+        return copy;
+    }
+
+    constexpr bool hasTransition(TState startState, TState finalState) const
+    {
+        return transitions[indexOf(startState)][indexOf(finalState)]
+               != nullptr;
+    }
+
+    constexpr bool hasAction(TState state) const
+    {
+        return actions[indexOf(state)] != nullptr;
+    }
+
+    static constexpr std::size_t indexOf(TState state)
+    {
+        auto idx = static_cast<std::size_t>(state);
+        if (idx >= N) {
+            throw std::out_of_range("State is outside of the enum table");
+        }
+        return idx;
+    }
+};
+
+template <const auto& Table> class EnumStateMachine
+{
+public:
+    using TableType = std::remove_cvref_t<decltype(Table)>;
+    using State = typename TableType::State;
+    using Context = typename TableType::Context;
+
+    explicit EnumStateMachine(State initial) :
+        current_(static_cast<StorageType>(TableType::indexOf(initial)))
+    {
+    }
+
+    State current() const { return static_cast<State>(current_); }
+
+    void transitionTo(State state, Context& ctx)
+    {
+        const std::size_t to = TableType::indexOf(state);
+        if (to == current_) {
+            return; // No transition needed
+        }
+        auto cb = Table.transitions[current_][to];
+        if (cb == nullptr) {
+            throw std::runtime_error("No transition defined to target state");
+        }
+        cb(ctx);
+        current_ = static_cast<StorageType>(to);
+    }
+
+    void update(Context& ctx)
+    {
+        auto cb = Table.actions[current_];
+        if (cb == nullptr) {
+            throw std::runtime_error("No action defined for current state");
+        }
+        cb(ctx);
+    }
+
+private:
+    // the smallest integer able to index the table keeps an instance tiny
+    using StorageType = std::conditional_t<
+        (TableType::kStateCount <= 0xFF),
+        std::uint8_t,
+        std::conditional_t<(TableType::kStateCount <= 0xFFFF),
+                           std::uint16_t,
+                           std::uint32_t>>;
+
+    StorageType current_;
+};
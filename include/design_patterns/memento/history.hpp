@@ -1,19 +1,134 @@
 // include/design_patterns/memento/history.hpp
 #pragma once
 #include "design_patterns/memento/memento.hpp"
+#include "design_patterns/memento/snapcompress.hpp"
+#include "design_patterns/memento/snapdelta.hpp"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
 #include <vector>
 
+/*
+Undo/redo stack of Memento snapshots.
+
+By default every push keeps the full Snapshot. With a keyframe interval K > 0
+(delta mode) only every K-th entry keeps a full Snapshot; the entries between
+store a snapdelta against the previous entry's bytes:
+
+    [ key ][ d ][ d ][ d ][ key ][ d ] ...
+       \____ rebuilt by applying deltas forward from the nearest keyframe
+
+Undo/redo rebuilds the target entry from its keyframe, so it costs at most K-1
+delta applications. A delta that would be larger than the full stream is
+stored as a keyframe instead.
+
+Bounds: maxEntries / maxBytes evict the oldest entries after each push (the
+current entry is never evicted; a delta that loses its base is rebased into a
+keyframe first).
+
+Compression: with compress = true every keyframe older than the newest
+hotEntries is packed with snapcompress, inline on push by default, or on a
+private background thread with backgroundCompression. Finished background
+work is picked up by the next push/undo/redo or by waitCompression(); work
+for entries evicted or dropped in the meantime is skipped. A copy gets its
+own background thread.
+*/
 class History
 {
 public:
+    struct Config
+    {
+        // 0 = store full snapshots only
+        std::size_t keyframeInterval = 0;
+        // 0 = unbounded
+        std::size_t maxEntries = 0;
+        std::size_t maxBytes = 0;
+        // pack keyframes that are not among the newest hotEntries
+        bool compress = false;
+        std::size_t hotEntries = 4;
+        // opt-in: starts one std::thread per History
+        bool backgroundCompression = false;
+    };
+
+    struct Stats
+    {
+        std::size_t entries = 0;
+        std::size_t bytes = 0; // currently held by all entries
+        std::size_t compressedEntries = 0;
+        std::size_t compressedBytes = 0;    // packed size of those entries
+        std::size_t compressedRawBytes = 0; // their uncompressed size
+        std::size_t evictedEntries = 0;     // since construction
+
+        double compressionRatio() const
+        {
+            return compressedRawBytes == 0
+                       ? 1.0
+                       : static_cast<double>(compressedBytes)
+                             / static_cast<double>(compressedRawBytes);
+        }
+    };
+
+    History() = default;
+    explicit History(Config config) :
+        config_(config), compactor_(_makeCompactor(config_))
+    {
+    }
+
+    // copies the entries; background jobs stay with rhs, so the entries
+    // they were packing are queued again by our next push
+    History(const History& rhs) :
+        config_(rhs.config_),
+        stack_(rhs.stack_),
+        idx_(rhs.idx_),
+        current_(rhs.current_),
+        bytes_(rhs.bytes_),
+        evicted_(rhs.evicted_),
+        packedUpTo_(rhs.packedUpTo_),
+        compactor_(_makeCompactor(config_))
+    {
+        for (std::size_t i = 0; i < stack_.size(); ++i) {
+            if (stack_[i].pending) {
+                stack_[i].pending.reset();
+                packedUpTo_ = std::min(packedUpTo_, i);
+            }
+        }
+    }
+
+    History& operator=(const History& rhs)
+    {
+        if (this != &rhs) {
+            History copy(rhs);
+            *this = std::move(copy);
+        }
+        return *this;
+    }
+
+    History(History&&) = default;
+    History& operator=(History&&) = default;
+
     void push(const Memento::Snapshot& state)
     {
+        _harvest();
         // if we are not at the top, drop all redo states
-        if (idx_ + 1 < stack_.size()) {
-            stack_.erase(stack_.begin() + idx_ + 1, stack_.end());
+        while (idx_ + 1 < stack_.size()) {
+            _forget(stack_.back());
+            stack_.pop_back();
+        }
+        packedUpTo_ = std::min(packedUpTo_, stack_.size());
+        if (config_.keyframeInterval == 0) {
+            _pushFull(state);
+        }
+        else {
+            _pushDelta(state);
         }
-        stack_.push_back(state);
         idx_ = stack_.size() - 1;
+        _enforceLimits();
+        _packColdEntries();
     }
 
     bool canUndo() const { return idx_ > 0; }
@@ -25,8 +140,9 @@ public:
         if (!canUndo()) {
             return false;
         }
+        _harvest();
         --idx_;
-        obj.load(stack_[idx_]);
+        obj.load(_materialize(idx_));
         return true;
     }
 
@@ -35,18 +151,349 @@ public:
         if (!canRedo()) {
             return false;
         }
+        _harvest();
         ++idx_;
-        obj.load(stack_[idx_]);
+        obj.load(_materialize(idx_));
         return true;
     }
 
     void clear()
     {
+        for (const auto& e : stack_) {
+            _forget(e);
+        }
         stack_.clear();
+        current_.clear();
+        bytes_ = 0;
+        pendingJobs_ = 0;
+        packedUpTo_ = 0;
         idx_ = 0;
     }
 
+    std::size_t size() const { return stack_.size(); }
+
+    // bytes held by the stored entries (keyframes, packed keyframes, deltas)
+    std::size_t storedBytes() const { return bytes_; }
+
+    Stats stats() const
+    {
+        Stats s;
+        s.entries = stack_.size();
+        s.bytes = bytes_;
+        s.evictedEntries = evicted_;
+        for (const auto& e : stack_) {
+            if (e.kind == Kind::Packed) {
+                ++s.compressedEntries;
+                s.compressedBytes += e.data.size();
+                s.compressedRawBytes += e.rawSize;
+            }
+        }
+        return s;
+    }
+
+    // block until background compression caught up, then apply its results
+    void waitCompression()
+    {
+        if (compactor_) {
+            compactor_->drain();
+        }
+        _harvest();
+    }
+
+private:
+    enum class Kind
+    {
+        Full,   // keyframe kept as a Snapshot
+        Packed, // keyframe compressed with snapcompress
+        Delta,  // snapdelta against the previous entry
+    };
+
+    struct PackJob
+    {
+        Memento::Snapshot source;
+        std::vector<std::byte> packed;
+        std::atomic<bool> done{false};
+        std::atomic<bool> cancelled{false}; // entry evicted or dropped
+    };
+
+    struct Entry
+    {
+        Kind kind = Kind::Full;
+        std::optional<Memento::Snapshot> full;
+        std::vector<std::byte> data; // packed stream or delta
+        std::size_t rawSize = 0;     // size of the uncompressed stream
+        std::shared_ptr<PackJob> pending;
+
+        std::size_t heldBytes() const
+        {
+            return kind == Kind::Full ? rawSize : data.size();
+        }
+    };
+
+    // single background thread packing cold keyframes
+    class Compactor
+    {
+    public:
+        Compactor() :
+            thread_([this]() {
+                _run();
+            })
+        {
+        }
+        ~Compactor()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stop_ = true;
+            }
+            cv_.notify_all();
+            thread_.join();
+        }
+
+        void submit(std::shared_ptr<PackJob> job)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                jobs_.push_back(std::move(job));
+            }
+            cv_.notify_all();
+        }
+
+        void drain()
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            idle_.wait(lock, [this]() {
+                return jobs_.empty() && !busy_;
+            });
+        }
+
+    private:
+        void _run()
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            while (true) {
+                cv_.wait(lock, [this]() {
+                    return stop_ || !jobs_.empty();
+                });
+                if (stop_) {
+                    // pending jobs are dropped, their entries stay unpacked
+                    return;
+                }
+                auto job = std::move(jobs_.front());
+                jobs_.pop_front();
+                busy_ = true;
+                lock.unlock();
+
+                if (!job->cancelled.load(std::memory_order_acquire)) {
+                    job->packed =
+                        snapcompress::compress(job->source.bytes());
+                }
+                job->source = Memento::Snapshot{};
+                job->done.store(true, std::memory_order_release);
+
+                lock.lock();
+                busy_ = false;
+                idle_.notify_all();
+            }
+        }
+
+        std::mutex mutex_;
+        std::condition_variable cv_;
+        std::condition_variable idle_;
+        std::deque<std::shared_ptr<PackJob>> jobs_;
+        bool busy_{false};
+        bool stop_{false};
+        std::thread thread_;
+    };
+
+    static std::unique_ptr<Compactor> _makeCompactor(const Config& config)
+    {
+        if (config.compress && config.backgroundCompression) {
+            return std::make_unique<Compactor>();
+        }
+        return nullptr;
+    }
+
+    void _pushFull(const Memento::Snapshot& state)
+    {
+        Entry e;
+        e.kind = Kind::Full;
+        e.full = state;
+        e.rawSize = state.size();
+        bytes_ += e.heldBytes();
+        stack_.push_back(std::move(e));
+    }
+
+    void _pushDelta(const Memento::Snapshot& state)
+    {
+        std::vector<std::byte> bytes = state.bytes();
+
+        std::size_t sinceKeyframe = 0;
+        for (std::size_t i = stack_.size();
+             i > 0 && stack_[i - 1].kind == Kind::Delta;
+             --i) {
+            ++sinceKeyframe;
+        }
+        const bool needKeyframe =
+            stack_.empty() || sinceKeyframe + 1 >= config_.keyframeInterval;
+
+        if (!needKeyframe) {
+            // current_ holds the bytes of the entry at idx_ (the new base)
+            auto delta = snapdelta::encode(current_, bytes);
+            if (delta.size() < bytes.size()) {
+                Entry e;
+                e.kind = Kind::Delta;
+                e.data = std::move(delta);
+                e.rawSize = bytes.size();
+                bytes_ += e.heldBytes();
+                stack_.push_back(std::move(e));
+                current_ = std::move(bytes);
+                return;
+            }
+        }
+        _pushFull(state);
+        current_ = std::move(bytes);
+    }
+
+    std::vector<std::byte> _bytesOf(std::size_t i) const
+    {
+        const Entry& e = stack_[i];
+        switch (e.kind) {
+        case Kind::Full:
+            return e.full->bytes();
+        case Kind::Packed:
+            return snapcompress::decompress(e.data);
+        case Kind::Delta:
+            break;
+        }
+        std::size_t k = i;
+        while (stack_[k].kind == Kind::Delta) {
+            --k;
+        }
+        std::vector<std::byte> bytes = _bytesOf(k);
+        for (std::size_t j = k + 1; j <= i; ++j) {
+            bytes = snapdelta::apply(bytes, stack_[j].data);
+        }
+        return bytes;
+    }
+
+    Memento::Snapshot _materialize(std::size_t i)
+    {
+        if (stack_[i].kind == Kind::Full) {
+            if (config_.keyframeInterval != 0) {
+                current_ = stack_[i].full->bytes();
+            }
+            return *stack_[i].full;
+        }
+        std::vector<std::byte> bytes = _bytesOf(i);
+        auto snap = Memento::Snapshot::fromBytes(bytes);
+        if (config_.keyframeInterval != 0) {
+            current_ = std::move(bytes);
+        }
+        return snap;
+    }
+
+    bool _overLimits() const
+    {
+        return (config_.maxEntries != 0 && stack_.size() > config_.maxEntries)
+               || (config_.maxBytes != 0 && bytes_ > config_.maxBytes);
+    }
+
+    void _enforceLimits()
+    {
+        // idx_ > 0 keeps the current entry alive whatever the budget says
+        while (idx_ > 0 && _overLimits()) {
+            if (stack_[1].kind == Kind::Delta) {
+                // the next entry loses its base, turn it into a keyframe
+                auto snap = Memento::Snapshot::fromBytes(_bytesOf(1));
+                bytes_ -= stack_[1].heldBytes();
+                stack_[1] = Entry{};
+                stack_[1].kind = Kind::Full;
+                stack_[1].rawSize = snap.size();
+                stack_[1].full = std::move(snap);
+                bytes_ += stack_[1].heldBytes();
+                // the new keyframe still needs packing
+                packedUpTo_ = std::min<std::size_t>(packedUpTo_, 1);
+            }
+            _forget(stack_.front());
+            stack_.pop_front();
+            --idx_;
+            if (packedUpTo_ > 0) {
+                --packedUpTo_;
+            }
+            ++evicted_;
+        }
+    }
+
+    void _packColdEntries()
+    {
+        if (!config_.compress || stack_.size() <= config_.hotEntries) {
+            return;
+        }
+        // entries below packedUpTo_ were handled by an earlier push
+        const std::size_t cold = stack_.size() - config_.hotEntries;
+        for (std::size_t i = packedUpTo_; i < cold; ++i) {
+            Entry& e = stack_[i];
+            if (e.kind != Kind::Full || e.pending) {
+                continue;
+            }
+            if (compactor_) {
+                e.pending = std::make_shared<PackJob>();
+                e.pending->source = *e.full;
+                compactor_->submit(e.pending);
+                ++pendingJobs_;
+            }
+            else {
+                _applyPacked(e, snapcompress::compress(e.full->bytes()));
+            }
+        }
+        packedUpTo_ = std::max(packedUpTo_, cold);
+    }
+
+    void _harvest()
+    {
+        if (pendingJobs_ == 0) {
+            return;
+        }
+        for (auto& e : stack_) {
+            if (e.pending && e.pending->done.load(std::memory_order_acquire)) {
+                auto packed = std::move(e.pending->packed);
+                e.pending.reset();
+                --pendingJobs_;
+                _applyPacked(e, std::move(packed));
+            }
+        }
+    }
+
+    // accounting for an entry about to be dropped
+    void _forget(const Entry& e)
+    {
+        bytes_ -= e.heldBytes();
+        if (e.pending) {
+            e.pending->cancelled.store(true, std::memory_order_release);
+            --pendingJobs_;
+        }
+    }
+
+    void _applyPacked(Entry& e, std::vector<std::byte> packed)
+    {
+        bytes_ -= e.heldBytes();
+        e.kind = Kind::Packed;
+        e.data = std::move(packed);
+        e.full.reset();
+        bytes_ += e.heldBytes();
+    }
+
 private:
-    std::vector<Memento::Snapshot> stack_;
+    Config config_{};
+    std::deque<Entry> stack_;
     std::size_t idx_{0};
+    // delta mode: serialized bytes of the entry at idx_
+    std::vector<std::byte> current_;
+    std::size_t bytes_{0};
+    std::size_t evicted_{0};
+    std::size_t pendingJobs_{0};
+    // entries [0, packedUpTo_) are packed, queued or not keyframes
+    std::size_t packedUpTo_{0};
+    std::unique_ptr<Compactor> compactor_;
 };
@@ -1,7 +1,12 @@
 // include/design_patterns/memento/memento.hpp
 #pragma once
 #include "snapio.hpp"
+#include <exception>
+#include <future>
+#include <memory>
+#include <span>
 #include <utility>
+#include <vector>
 
 class Memento
 {
@@ -9,24 +14,71 @@ public:
     class Snapshot
     {
     public:
-        Snapshot() : io_(VectorBackend{}) {}
+        Snapshot() : io_(std::make_shared<SnapIO>(VectorBackend{})) {}
         // force user needs to claim specifically, avoid implicit casting
         template <class Backend>
-        explicit Snapshot(Backend b) : io_(std::forward<Backend>(b))
+        explicit Snapshot(Backend b) :
+            io_(std::make_shared<SnapIO>(std::forward<Backend>(b)))
         {
         }
 
-        // the SnapIO support copy/move so we can use default here
+        // copies share the stream (refcount bump); the first mutable access
+        // through io() on a shared Snapshot detaches it (copy-on-write)
         Snapshot(const Snapshot&) = default;
         Snapshot& operator=(const Snapshot&) = default;
         Snapshot(Snapshot&&) noexcept = default;
         Snapshot& operator=(Snapshot&&) noexcept = default;
         ~Snapshot() = default;
 
+        std::size_t size() const { return io_->size(); }
+
+        // raw serialized stream, independent of the backend that produced it
+        std::vector<std::byte> bytes() const
+        {
+            if (auto view = io_->contiguous()) {
+                return std::vector<std::byte>(view->begin(), view->end());
+            }
+            SnapIO io = *io_;
+            std::vector<std::byte> out(io.size());
+            io.seek(0);
+            if (!out.empty()) {
+                io.read(out.data(), out.size());
+            }
+            return out;
+        }
+
+        static Snapshot fromBytes(std::span<const std::byte> bytes)
+        {
+            VectorBackend b;
+            if (!bytes.empty()) {
+                b.write(bytes.data(), bytes.size());
+            }
+            return Snapshot(std::move(b));
+        }
+
     private:
-        SnapIO io_;
-        SnapIO& io() { return io_; }
-        const SnapIO& io() const { return io_; }
+        std::shared_ptr<SnapIO> io_;
+
+        SnapIO& io()
+        {
+            if (io_.use_count() > 1) {
+                io_ = std::make_shared<SnapIO>(*io_);
+            }
+            return *io_;
+        }
+        const SnapIO& io() const { return *io_; }
+
+        // a Snapshot reading the same bytes with its own cursor
+        Snapshot _reader() const
+        {
+            if (auto view = io_->contiguous()) {
+                return Snapshot(ViewBackend(*view, io_, io_->tell()));
+            }
+            // backend without contiguous storage: private copy
+            Snapshot copy = *this;
+            copy.io();
+            return copy;
+        }
 
         // only allow memento to use internal io
         friend class Memento;
@@ -38,15 +90,52 @@ public:
     {
         Snapshot s(createBackend());
         _saveToSnapshot(s);
+        // settle SnapIO's staged bytes so the stored snapshot is immutable
+        stream(s).flush();
         return s;
     }
     // will base on the Snapshot to restore the state by _loadFromSnapshot
+    // reads in place through a private cursor, the stored bytes are not copied
     void load(const Memento::Snapshot& state)
     {
-        Snapshot copy = state;
-        _loadFromSnapshot(copy);
+        Snapshot reader = state._reader();
+        _loadFromSnapshot(reader);
+    }
+
+    // Asynchronous checkpoint: the caller only pays for _freeze(), the
+    // serialization of the frozen copy runs as a job on `executor` (anything
+    // with addJob(std::function<void()>), e.g. WorkerPool). Without a
+    // _freeze() override there is nothing safe to hand to another thread, so
+    // the snapshot is taken synchronously and the future is already ready.
+    template <class Executor>
+    std::future<Snapshot> saveAsync(Executor& executor) const
+    {
+        auto promise = std::make_shared<std::promise<Snapshot>>();
+        auto future = promise->get_future();
+
+        std::shared_ptr<const Memento> frozen = _freeze();
+        if (!frozen) {
+            try {
+                promise->set_value(save());
+            }
+            catch (...) {
+                promise->set_exception(std::current_exception());
+            }
+            return future;
+        }
+        executor.addJob([frozen, promise]() {
+            try {
+                promise->set_value(frozen->save());
+            }
+            catch (...) {
+                promise->set_exception(std::current_exception());
+            }
+        });
+        return future;
     }
 
+    virtual ~Memento() = default;
+
 protected:
     // provide access to Snapshot's io
     // eventhough Snapshot is private nested, Memento can access its private
@@ -58,6 +147,13 @@ protected:
 
     virtual SnapIO createBackend() const { return VectorBackend{}; }
 
+    // freeze hook for saveAsync(): return an immutable copy of the current
+    // state that stays consistent while the caller keeps mutating this object.
+    // Cheapest when the heavy state is held through shared_ptr<const T>, so
+    // the copy is a refcount bump and mutations replace rather than edit it:
+    //     return std::make_shared<const World>(*this);
+    virtual std::shared_ptr<const Memento> _freeze() const { return nullptr; }
+
 private:
     virtual void _saveToSnapshot(Snapshot& s) const = 0;
     virtual void _loadFromSnapshot(Snapshot& s) = 0;
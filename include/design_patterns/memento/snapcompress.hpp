@@ -0,0 +1,107 @@
+// include/design_patterns/memento/snapcompress.hpp
+#pragma once
+#include "data_structures/tlv.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+/*
+Small LZ77 compressor for cold History snapshots.
+
+No external dependency: snapshots are TLV streams with many repeated headers,
+zero runs and similar strings, which a greedy single-probe LZ already shrinks
+well. Speed matters more than ratio since it runs on every evicted-to-cold
+snapshot.
+
+    varuint  raw size
+    repeat:
+        varuint  literal length, literal bytes
+        varuint  match length (>= kMinMatch), varuint match distance
+    (the last token may stop right after its literals)
+*/
+namespace snapcompress
+{
+
+constexpr std::size_t kMinMatch = 4;
+constexpr std::size_t kHashBits = 14;
+
+inline std::vector<std::byte> compress(std::span<const std::byte> in)
+{
+    std::vector<std::byte> out;
+    out.reserve(in.size() / 2 + 16);
+    tlv::VectorWriter w{out};
+    tlv::detail::write_varuint(w, in.size());
+
+    // last position seen for each 4-byte hash
+    std::vector<std::uint32_t> table(std::size_t{1} << kHashBits, UINT32_MAX);
+    auto hashAt = [&](std::size_t p) {
+        std::uint32_t v;
+        std::memcpy(&v, in.data() + p, sizeof(v));
+        return (v * 2654435761u) >> (32 - kHashBits);
+    };
+
+    std::size_t litBegin = 0;
+    std::size_t pos = 0;
+    while (pos + kMinMatch <= in.size()) {
+        const auto h = hashAt(pos);
+        const std::uint32_t cand = table[h];
+        table[h] = static_cast<std::uint32_t>(pos);
+
+        if (cand == UINT32_MAX
+            || std::memcmp(in.data() + cand, in.data() + pos, kMinMatch) != 0) {
+            ++pos;
+            continue;
+        }
+        std::size_t len = kMinMatch;
+        while (pos + len < in.size() && in[cand + len] == in[pos + len]) {
+            ++len;
+        }
+        tlv::detail::write_varuint(w, pos - litBegin);
+        w.writeBytes(in.subspan(litBegin, pos - litBegin));
+        tlv::detail::write_varuint(w, len);
+        tlv::detail::write_varuint(w, pos - cand);
+        pos += len;
+        litBegin = pos;
+    }
+    if (litBegin < in.size() || in.empty()) {
+        tlv::detail::write_varuint(w, in.size() - litBegin);
+        w.writeBytes(in.subspan(litBegin));
+    }
+    return out;
+}
+
+inline std::vector<std::byte> decompress(std::span<const std::byte> in)
+{
+    tlv::SpanReader r{in};
+    const std::size_t size = tlv::detail::read_varuint(r);
+
+    std::vector<std::byte> out(size);
+    std::size_t pos = 0;
+    while (pos < size) {
+        const std::size_t lit = tlv::detail::read_varuint(r);
+        if (lit > size - pos) {
+            throw std::runtime_error("snapcompress: literal overflow");
+        }
+        r.readExact(out.data() + pos, lit);
+        pos += lit;
+        if (pos == size) {
+            break;
+        }
+        const std::size_t len = tlv::detail::read_varuint(r);
+        const std::size_t dist = tlv::detail::read_varuint(r);
+        if (len < kMinMatch || len > size - pos || dist == 0 || dist > pos) {
+            throw std::runtime_error("snapcompress: corrupt match");
+        }
+        // byte by byte: matches may overlap their own output
+        for (std::size_t i = 0; i < len; ++i, ++pos) {
+            out[pos] = out[pos - dist];
+        }
+    }
+    return out;
+}
+
+} // namespace snapcompress
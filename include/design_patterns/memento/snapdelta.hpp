@@ -0,0 +1,114 @@
+// include/design_patterns/memento/snapdelta.hpp
+#pragma once
+#include "data_structures/tlv.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+/*
+Binary diff between two consecutive snapshot byte streams.
+
+Snapshots of the same object are mostly identical: fields are serialized in
+the same order, so unchanged fields sit at the same offset and a resized
+string or container only shifts the tail. The delta therefore is:
+
+    varuint  target size
+    varuint  common suffix length (copied from the end of base)
+    repeat until the middle part is rebuilt:
+        varuint  equal run   (copied from base at the same offset)
+        varuint  literal run
+        bytes    literal run bytes
+
+The encoder only ends a literal run when at least kMinMatch bytes match again,
+so scattered single byte changes do not cost two varints each.
+*/
+namespace snapdelta
+{
+
+constexpr std::size_t kMinMatch = 4;
+
+inline std::vector<std::byte> encode(std::span<const std::byte> base,
+                                     std::span<const std::byte> target)
+{
+    std::vector<std::byte> out;
+    tlv::VectorWriter w{out};
+
+    std::size_t suffix = 0;
+    const std::size_t maxSuffix = std::min(base.size(), target.size());
+    while (suffix < maxSuffix
+           && base[base.size() - 1 - suffix]
+                  == target[target.size() - 1 - suffix]) {
+        ++suffix;
+    }
+    const std::size_t middleEnd = target.size() - suffix;
+
+    tlv::detail::write_varuint(w, target.size());
+    tlv::detail::write_varuint(w, suffix);
+
+    auto same = [&](std::size_t p) {
+        return p < base.size() && base[p] == target[p];
+    };
+    auto matchStarts = [&](std::size_t p) {
+        if (p + kMinMatch > middleEnd) {
+            return false;
+        }
+        for (std::size_t j = 0; j < kMinMatch; ++j) {
+            if (!same(p + j)) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    std::size_t pos = 0;
+    while (pos < middleEnd) {
+        std::size_t eq = 0;
+        while (pos + eq < middleEnd && same(pos + eq)) {
+            ++eq;
+        }
+        std::size_t litBegin = pos + eq;
+        std::size_t litEnd = litBegin;
+        while (litEnd < middleEnd && !matchStarts(litEnd)) {
+            ++litEnd;
+        }
+        tlv::detail::write_varuint(w, eq);
+        tlv::detail::write_varuint(w, litEnd - litBegin);
+        w.writeBytes(target.subspan(litBegin, litEnd - litBegin));
+        pos = litEnd;
+    }
+    return out;
+}
+
+inline std::vector<std::byte> apply(std::span<const std::byte> base,
+                                    std::span<const std::byte> delta)
+{
+    tlv::SpanReader r{delta};
+    const std::size_t size = tlv::detail::read_varuint(r);
+    const std::size_t suffix = tlv::detail::read_varuint(r);
+    if (suffix > size || suffix > base.size()) {
+        throw std::runtime_error("snapdelta: suffix out of range");
+    }
+    const std::size_t middleEnd = size - suffix;
+
+    std::vector<std::byte> out;
+    out.reserve(size);
+    while (out.size() < middleEnd) {
+        const std::size_t eq = tlv::detail::read_varuint(r);
+        const std::size_t lit = tlv::detail::read_varuint(r);
+        const std::size_t pos = out.size();
+        const std::size_t baseLeft = pos < base.size() ? base.size() - pos : 0;
+        if ((eq == 0 && lit == 0) || eq > baseLeft
+            || eq + lit > middleEnd - pos) {
+            throw std::runtime_error("snapdelta: corrupt run");
+        }
+        out.insert(out.end(), base.begin() + pos, base.begin() + pos + eq);
+        out.resize(pos + eq + lit);
+        r.readExact(out.data() + pos + eq, lit);
+    }
+    out.insert(out.end(), base.end() - suffix, base.end());
+    return out;
+}
+
+} // namespace snapdelta
@@ -1,42 +1,183 @@
 // include/design_patterns/memento/snapio.hpp
 #pragma once
 #include "data_structures/data_buffer.hpp"
+#include <array>
 #include <cstddef>
 #include <cstring>
 #include <memory>
+#include <optional>
+#include <span>
+#include <stdexcept>
 #include <type_traits>
 #include <utility>
 #include <vector>
 
+/*
+SnapIO is a type-erased byte stream: every backend call is virtual. TLV
+encoding writes a header byte, a varint and a payload per field, so SnapIO
+batches on its side of the boundary:
+
+  - writes are staged in a small buffer and handed to the backend in chunks
+    of up to kStageSize bytes (larger writes go straight through); flush()
+    hands over the rest and releases the buffer, so a finished stream does
+    not carry it
+  - reads from a backend that exposes its bytes contiguously are served from
+    a cached window with a local cursor; the backend cursor is synced back
+    before any other mutating operation
+
+Only the non-const paths (write/read/seek/flush) settle the pending state.
+Const accessors never touch the backend's state, so one SnapIO can be read
+from several threads: tell() and size() account for the pending state,
+copies take it over, and contiguous() is std::nullopt while writes are
+still staged (call flush() first).
+*/
 class SnapIO
 {
 public:
+    using ByteView = std::span<const std::byte>;
+
+    static constexpr size_t kStageSize = 256;
+
     // template ctor bridge pattern
     // to make any form meet the IOConcept interface wrap to IOModel<Backend>
+    // (SnapIO itself is excluded so copies of a non-const SnapIO& still
+    // reach the copy ctor instead of being wrapped)
     template <class Backend>
+        requires(!std::is_same_v<std::decay_t<Backend>, SnapIO>)
     SnapIO(Backend&& x) :
         // use decay to remove ref/const qualifer
         pimpl_{std::make_unique<IOModel<std::decay_t<Backend>>>(
-            std::forward<Backend>(x))}
+            std::forward<Backend>(x))},
+        windowed_(pimpl_->contiguous().has_value())
     {
     }
-    SnapIO(const SnapIO& rhs) : pimpl_(rhs.pimpl_->clone()) {}
+    SnapIO(const SnapIO& rhs) :
+        pimpl_(rhs.pimpl_->clone()), windowed_(rhs.windowed_),
+        staged_(rhs.staged_)
+    {
+        // the clone gets the pending state without rhs being modified
+        if (staged_ != 0) {
+            stage_ = std::make_unique<Stage>(*rhs.stage_);
+        }
+        if (rhs.reading_) {
+            pimpl_->seek(rhs.rd_);
+        }
+    }
     SnapIO& operator=(const SnapIO& rhs)
     {
         if (this != &rhs) {
-            pimpl_ = rhs.pimpl_->clone();
+            SnapIO tmp(rhs);
+            *this = std::move(tmp);
         }
         return *this;
     }
-    SnapIO(SnapIO&&) noexcept = default;
-    SnapIO& operator=(SnapIO&&) noexcept = default;
-    ~SnapIO() = default;
+    SnapIO(SnapIO&& rhs) noexcept :
+        pimpl_(std::move(rhs.pimpl_)),
+        windowed_(rhs.windowed_),
+        stage_(std::move(rhs.stage_)),
+        staged_(std::exchange(rhs.staged_, 0)),
+        reading_(std::exchange(rhs.reading_, false)),
+        window_(rhs.window_),
+        rd_(rhs.rd_)
+    {
+    }
+    SnapIO& operator=(SnapIO&& rhs) noexcept
+    {
+        if (this != &rhs) {
+            // the old backend gets its pending bytes before it is released
+            SnapIO old(std::move(*this));
+            pimpl_ = std::move(rhs.pimpl_);
+            windowed_ = rhs.windowed_;
+            stage_ = std::move(rhs.stage_);
+            staged_ = std::exchange(rhs.staged_, 0);
+            reading_ = std::exchange(rhs.reading_, false);
+            window_ = rhs.window_;
+            rd_ = rhs.rd_;
+        }
+        return *this;
+    }
+    ~SnapIO()
+    {
+        if (pimpl_ && staged_ != 0) {
+            try {
+                pimpl_->write(stage_->data(), staged_);
+            }
+            catch (...) {
+                // nothing to report to from a destructor; flush() surfaces it
+            }
+        }
+    }
+
+    void write(const void* p, size_t n)
+    {
+        if (reading_) {
+            _settle();
+        }
+        if (n == 0) {
+            return;
+        }
+        if (n <= kStageSize - staged_) {
+            _stage(p, n);
+            return;
+        }
+        _settle();
+        if (n >= kStageSize) {
+            pimpl_->write(p, n);
+            return;
+        }
+        _stage(p, n);
+    }
 
-    void write(const void* p, size_t n) { pimpl_->write(p, n); }
-    void read(void* p, size_t n) { pimpl_->read(p, n); }
-    size_t tell() const { return pimpl_->tell(); }
-    void seek(size_t pos) { pimpl_->seek(pos); }
-    size_t size() const { return pimpl_->size(); }
+    void read(void* p, size_t n)
+    {
+        if (!reading_) {
+            _settle();
+            if (!windowed_) {
+                pimpl_->read(p, n);
+                return;
+            }
+            window_ = *pimpl_->contiguous();
+            rd_ = pimpl_->tell();
+            reading_ = true;
+        }
+        if (n > window_.size() - rd_) {
+            // let the backend report the overflow in its own terms
+            _settle();
+            pimpl_->read(p, n);
+            return;
+        }
+        if (n != 0) {
+            std::memcpy(p, window_.data() + rd_, n);
+        }
+        rd_ += n;
+    }
+
+    // staged bytes are appended at the end, so they never move the cursor
+    size_t tell() const { return reading_ ? rd_ : pimpl_->tell(); }
+    void seek(size_t pos)
+    {
+        _settle();
+        pimpl_->seek(pos);
+    }
+    size_t size() const { return pimpl_->size() + staged_; }
+    // the whole stream as one readable range, when the backend stores it
+    // contiguously and no write is staged (std::nullopt otherwise)
+    std::optional<ByteView> contiguous() const
+    {
+        if (staged_ != 0) {
+            return std::nullopt;
+        }
+        return pimpl_->contiguous();
+    }
+    // hand staged bytes to the backend now and drop the stage buffer, and
+    // let backends that buffer on their own (e.g. FileBackend) push them to
+    // their storage
+    void flush()
+    {
+        _settle();
+        stage_.reset();
+        pimpl_->flush();
+    }
 
 private:
     // interface only
@@ -47,6 +188,8 @@ private:
         virtual size_t tell() const = 0;
         virtual void seek(size_t pos) = 0;
         virtual size_t size() const = 0;
+        virtual std::optional<ByteView> contiguous() const = 0;
+        virtual void flush() = 0;
         virtual std::unique_ptr<IOConcept> clone() const = 0;
         virtual ~IOConcept() = default;
     };
@@ -60,6 +203,25 @@ private:
         size_t tell() const override { return b.tell(); }
         void seek(size_t pos) override { b.seek(pos); }
         size_t size() const override { return b.size(); }
+        std::optional<ByteView> contiguous() const override
+        {
+            // opt-in: backends exposing data() are readable in place
+            if constexpr (requires(const Backend& c) {
+                              { c.data() } -> std::same_as<const std::byte*>;
+                          }) {
+                return ByteView(b.data(), b.size());
+            }
+            else {
+                return std::nullopt;
+            }
+        }
+        void flush() override
+        {
+            // opt-in as well: only backends with their own buffering
+            if constexpr (requires(Backend& c) { c.flush(); }) {
+                b.flush();
+            }
+        }
         std::unique_ptr<IOConcept> clone() const override
         {
             return std::make_unique<IOModel<Backend>>(*this);
@@ -68,7 +230,39 @@ private:
         Backend b;
     };
 
+    using Stage = std::array<std::byte, kStageSize>;
+
+    void _stage(const void* p, size_t n)
+    {
+        if (!stage_) {
+            stage_ = std::make_unique<Stage>();
+        }
+        std::memcpy(stage_->data() + staged_, p, n);
+        staged_ += n;
+    }
+
+    // push staged writes / sync the read cursor back to the backend
+    void _settle()
+    {
+        if (staged_ != 0) {
+            const size_t n = staged_;
+            staged_ = 0;
+            pimpl_->write(stage_->data(), n);
+        }
+        if (reading_) {
+            reading_ = false;
+            pimpl_->seek(rd_);
+        }
+    }
+
     std::unique_ptr<IOConcept> pimpl_;
+    bool windowed_{false};
+    // batching state, logically part of the backend's stream
+    std::unique_ptr<Stage> stage_; // allocated by the first staged write
+    size_t staged_{0};
+    bool reading_{false};
+    ByteView window_{};
+    size_t rd_{0};
 };
 
 struct VectorBackend
@@ -102,12 +296,58 @@ struct VectorBackend
     }
 
     size_t size() const { return buf_.size(); }
+    const std::byte* data() const { return buf_.data(); }
 
 private:
     std::vector<std::byte> buf_;
     size_t rd_{0};
 };
 
+// read-only cursor over bytes owned by someone else; owner keeps them alive
+struct ViewBackend
+{
+    explicit ViewBackend(std::span<const std::byte> bytes,
+                         std::shared_ptr<const void> owner = nullptr,
+                         size_t pos = 0) :
+        bytes_(bytes), owner_(std::move(owner)), rd_(pos)
+    {
+    }
+
+    void write(const void*, size_t)
+    {
+        throw std::logic_error("ViewBackend is read-only");
+    }
+
+    void read(void* p, size_t n)
+    {
+        if (n > bytes_.size() - rd_) {
+            throw std::out_of_range("ViewBackend read overflow");
+        }
+        if (n != 0) {
+            std::memcpy(p, bytes_.data() + rd_, n);
+        }
+        rd_ += n;
+    }
+
+    size_t tell() const { return rd_; }
+
+    void seek(size_t pos)
+    {
+        if (pos > bytes_.size()) {
+            throw std::out_of_range("ViewBackend seek past end");
+        }
+        rd_ = pos;
+    }
+
+    size_t size() const { return bytes_.size(); }
+    const std::byte* data() const { return bytes_.data(); }
+
+private:
+    std::span<const std::byte> bytes_;
+    std::shared_ptr<const void> owner_;
+    size_t rd_{0};
+};
+
 struct DataBufferBackend
 {
 public:
@@ -148,6 +388,8 @@ public:
     size_t tell() const { return db_->tell(); }
     void seek(size_t pos) { db_->seek(pos); }
     size_t size() const { return db_->size(); }
+    // DataBuffer::data() starts at its read cursor, the stream starts before
+    const std::byte* data() const { return db_->data() - db_->tell(); }
 
     const DataBuffer& inner() const { return *db_; }
 
@@ -0,0 +1,286 @@
+// include/design_patterns/memento/snapio_file.hpp
+#pragma once
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <fcntl.h>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+/*
+Persistent SnapIO backends, for snapshots too large to keep on the heap.
+
+FileBackend   streams writes to a file through a fixed-size buffer flushed
+              with pwrite; reads use pread with a read-ahead buffer. Copies
+              share the open file (and its pending buffer) with their own
+              read cursor, so the fallback copy in Memento::load() is cheap.
+
+MmapBackend   read-only mapping of an existing snapshot file. It exposes
+              data(), so Memento::load() reads straight from the page cache
+              through SnapIO's window without materializing the bytes.
+
+    struct Sim : Memento {
+        SnapIO createBackend() const override
+        {
+            return SnapIO{FileBackend("ckpt.bin")};
+        }
+    };
+    sim.save();                                   // streamed to ckpt.bin
+    sim.load(Memento::Snapshot(MmapBackend("ckpt.bin")));
+*/
+
+namespace snapio_file_detail
+{
+
+inline std::runtime_error sysError(const std::string& what)
+{
+    return std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+} // namespace snapio_file_detail
+
+class FileBackend
+{
+public:
+    static constexpr size_t kBufferSize = 64 * 1024;
+
+    // creates or truncates the file at path
+    explicit FileBackend(const std::string& path) :
+        file_(std::make_shared<File>(path))
+    {
+    }
+
+    void write(const void* p, size_t n)
+    {
+        File& f = *file_;
+        if (f.pending.size() + n > kBufferSize) {
+            f.flushPending();
+        }
+        if (n >= kBufferSize) {
+            f.pwriteAll(p, n);
+            return;
+        }
+        auto* b = static_cast<const std::byte*>(p);
+        f.pending.insert(f.pending.end(), b, b + n);
+    }
+
+    void read(void* p, size_t n)
+    {
+        if (n > size() - rd_) {
+            throw std::out_of_range("FileBackend read overflow");
+        }
+        auto* out = static_cast<std::byte*>(p);
+        // bytes already on disk never change, so the read-ahead stays valid
+        if (rd_ < ahead_ || rd_ + n > ahead_ + rbuf_.size()) {
+            file_->flushPending();
+            if (n >= kBufferSize) {
+                file_->preadAll(out, n, rd_);
+                rd_ += n;
+                return;
+            }
+            rbuf_.resize(std::min(kBufferSize, size() - rd_));
+            file_->preadAll(rbuf_.data(), rbuf_.size(), rd_);
+            ahead_ = rd_;
+        }
+        if (n != 0) {
+            std::memcpy(out, rbuf_.data() + (rd_ - ahead_), n);
+        }
+        rd_ += n;
+    }
+
+    size_t tell() const { return rd_; }
+
+    void seek(size_t pos)
+    {
+        if (pos > size()) {
+            throw std::out_of_range("FileBackend seek past end");
+        }
+        rd_ = pos;
+    }
+
+    size_t size() const { return file_->flushed + file_->pending.size(); }
+
+    void flush() { file_->flushPending(); }
+
+    const std::string& path() const { return file_->path; }
+
+private:
+    struct File
+    {
+        explicit File(const std::string& p) : path(p)
+        {
+            const int flags = O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC;
+            fd = ::open(p.c_str(), flags, 0644);
+            if (fd == -1) {
+                throw snapio_file_detail::sysError("FileBackend open '" + p
+                                                   + "' failed");
+            }
+            pending.reserve(kBufferSize);
+        }
+        ~File()
+        {
+            try {
+                flushPending();
+            }
+            catch (...) {
+                // last owner is going away, nobody left to tell
+            }
+            ::close(fd);
+        }
+        File(const File&) = delete;
+        File& operator=(const File&) = delete;
+
+        void pwriteAll(const void* p, size_t n)
+        {
+            auto* b = static_cast<const std::byte*>(p);
+            size_t done = 0;
+            while (done < n) {
+                ssize_t w = ::pwrite(fd,
+                                     b + done,
+                                     n - done,
+                                     static_cast<off_t>(flushed + done));
+                if (w < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (w < 0) {
+                    throw snapio_file_detail::sysError(
+                        "FileBackend pwrite failed");
+                }
+                done += static_cast<size_t>(w);
+            }
+            flushed += n;
+        }
+
+        void preadAll(std::byte* out, size_t n, size_t offset) const
+        {
+            size_t done = 0;
+            while (done < n) {
+                ssize_t r = ::pread(fd,
+                                    out + done,
+                                    n - done,
+                                    static_cast<off_t>(offset + done));
+                if (r < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (r <= 0) {
+                    throw snapio_file_detail::sysError(
+                        "FileBackend pread failed");
+                }
+                done += static_cast<size_t>(r);
+            }
+        }
+
+        void flushPending()
+        {
+            if (pending.empty()) {
+                return;
+            }
+            pwriteAll(pending.data(), pending.size());
+            pending.clear();
+        }
+
+        std::string path;
+        int fd{-1};
+        size_t flushed{0}; // bytes already on disk
+        std::vector<std::byte> pending;
+    };
+
+    std::shared_ptr<File> file_;
+    size_t rd_{0};
+    // read-ahead window [ahead_, ahead_ + rbuf_.size()), per cursor
+    std::vector<std::byte> rbuf_;
+    size_t ahead_{0};
+};
+
+class MmapBackend
+{
+public:
+    explicit MmapBackend(const std::string& path) :
+        map_(std::make_shared<Mapping>(path))
+    {
+    }
+
+    void write(const void*, size_t)
+    {
+        throw std::logic_error("MmapBackend is read-only");
+    }
+
+    void read(void* p, size_t n)
+    {
+        if (n > map_->len - rd_) {
+            throw std::out_of_range("MmapBackend read overflow");
+        }
+        if (n != 0) {
+            std::memcpy(p, data() + rd_, n);
+        }
+        rd_ += n;
+    }
+
+    size_t tell() const { return rd_; }
+
+    void seek(size_t pos)
+    {
+        if (pos > map_->len) {
+            throw std::out_of_range("MmapBackend seek past end");
+        }
+        rd_ = pos;
+    }
+
+    size_t size() const { return map_->len; }
+    const std::byte* data() const
+    {
+        return static_cast<const std::byte*>(map_->addr);
+    }
+
+private:
+    struct Mapping
+    {
+        explicit Mapping(const std::string& path)
+        {
+            int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd == -1) {
+                throw snapio_file_detail::sysError("MmapBackend open '" + path
+                                                   + "' failed");
+            }
+            struct stat st;
+            if (::fstat(fd, &st) == -1) {
+                auto err = snapio_file_detail::sysError("MmapBackend fstat");
+                ::close(fd);
+                throw err;
+            }
+            len = static_cast<size_t>(st.st_size);
+            if (len != 0) {
+                addr = ::mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (addr == MAP_FAILED) {
+                    auto err = snapio_file_detail::sysError("MmapBackend mmap");
+                    ::close(fd);
+                    throw err;
+                }
+                // snapshots are restored front to back
+                ::madvise(addr, len, MADV_SEQUENTIAL);
+            }
+            // the mapping stays valid after the descriptor is closed
+            ::close(fd);
+        }
+        ~Mapping()
+        {
+            if (addr != nullptr) {
+                ::munmap(addr, len);
+            }
+        }
+        Mapping(const Mapping&) = delete;
+        Mapping& operator=(const Mapping&) = delete;
+
+        void* addr{nullptr};
+        size_t len{0};
+    };
+
+    std::shared_ptr<Mapping> map_;
+    size_t rd_{0};
+};
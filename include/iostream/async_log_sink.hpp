@@ -0,0 +1,95 @@
+// include/iostream/async_log_sink.hpp
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unistd.h>
+
+/*
+Background writer behind ThreadSafeIOStream's async mode.
+
+Logging threads hand finished records (one or more complete, prefixed
+lines) to a bounded lock-free ring; a single writer thread takes whatever
+has accumulated and writes it to the fd with one writev() per drain:
+
+    thread A --push--+
+    thread B --push--+--> [ ring: seq | record ]... --> writer --writev--> fd
+    thread C --push--+
+
+Producers only claim a slot with a CAS, copy the record into the slot's
+buffer and publish it with a store, so logging threads never serialize on
+a mutex and never pay a syscall, except to wake the writer when it is
+asleep. The writer swaps its emptied buffers back into the slots it takes,
+so once the buffers have grown to the usual line length nothing allocates.
+A full ring makes producers back off (yield) until the writer frees
+slots: lines are never dropped.
+
+Records from one push are written contiguously; records from different
+threads are ordered by the moment they were pushed.
+*/
+class AsyncLogSink
+{
+public:
+    static constexpr size_t kDefaultCapacity = 4096;
+    static constexpr size_t kMaxBatch = 1024; // IOV_MAX on Linux
+
+    // capacity is rounded up to a power of two
+    explicit AsyncLogSink(int fd = STDOUT_FILENO,
+                          size_t capacity = kDefaultCapacity);
+    // writes everything pushed so far, then stops the writer
+    ~AsyncLogSink();
+
+    AsyncLogSink(const AsyncLogSink&) = delete;
+    AsyncLogSink& operator=(const AsyncLogSink&) = delete;
+
+    // safe from any thread; blocks only while the ring is full
+    void push(std::string_view record);
+
+    // returns once every record pushed before the call has been written
+    void drain();
+
+    size_t capacity() const { return mask_ + 1; }
+    // records written / writev calls made so far
+    std::uint64_t written() const
+    {
+        return written_.load(std::memory_order_acquire);
+    }
+    std::uint64_t batches() const
+    {
+        return batches_.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Slot
+    {
+        std::atomic<std::uint64_t> seq{0};
+        std::string text;
+    };
+
+    void _run();
+    size_t _take(std::string* batch);
+    void _write(const std::string* batch, size_t count);
+
+private:
+    int fd_;
+    size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+
+    // producers
+    alignas(64) std::atomic<std::uint64_t> tail_{0};
+    // writer
+    alignas(64) std::uint64_t head_{0};
+    std::atomic<std::uint64_t> written_{0};
+    std::atomic<std::uint64_t> batches_{0};
+
+    // wake-up of a sleeping writer
+    alignas(64) std::atomic<bool> sleeping_{false};
+    std::atomic<std::uint32_t> wake_{0};
+    std::atomic<bool> stop_{false};
+
+    std::thread writer_;
+};
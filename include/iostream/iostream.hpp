@@ -1,3 +1,4 @@
 #pragma once
 
+#include "async_log_sink.hpp"
 #include "thread_safe_iostream.hpp"
@@ -1,26 +1,45 @@
 #pragma once
+#include "async_log_sink.hpp"
 #include <iostream>
 #include <mutex>
 #include <sstream>
 #include <string>
+#include <string_view>
 
 inline std::mutex g_cin_mutex;
 inline std::mutex g_cout_mutex;
 
+/*
+Per-thread line-buffered output: each thread formats into its own buffer
+and only complete lines, prefixed, reach the output, so lines from
+different threads never interleave.
+
+By default lines go to std::cout under g_cout_mutex. enableAsync() routes
+them to an AsyncLogSink instead: the logging thread copies its lines into
+a lock-free ring and a background thread writes them with writev(), so
+logging threads neither contend on the mutex nor wait for the terminal:
+
+    ThreadSafeIOStream::enableAsync();        // at startup
+    ts_cout << "request " << id << " done\n";  // no lock, no syscall
+    ThreadSafeIOStream::disableAsync();       // at shutdown, drains
+
+Switch modes while no other thread is logging. In async mode flush() also
+waits until the writer has caught up; output written straight to
+std::cout is not ordered with the async lines.
+*/
 class ThreadSafeIOStream
 {
 public:
+    static void enableAsync(int fd = STDOUT_FILENO,
+                            size_t capacity = AsyncLogSink::kDefaultCapacity);
+    static void disableAsync();
+    static bool isAsync();
+
     void setPrefix(const std::string& prefix);
 
     template <typename T> void prompt(const std::string& question, T& dest)
     {
-        // std::lock_guard only locks for the duration of its scope
-        {
-            // lock cout to print question
-            std::lock_guard<std::mutex> lock(g_cout_mutex);
-            std::cout << prefix_ << question << std::endl;
-            // cout lock released here
-        }
+        _printQuestion(question);
         {
             // lock cin to read answer
             std::lock_guard<std::mutex> lock(g_cin_mutex);
@@ -57,10 +76,13 @@ public:
 
 private:
     void _flushCompletedLines();
+    void _printQuestion(const std::string& question);
+    void _write(std::string_view text);
 
 private:
     std::string prefix_;
     std::ostringstream buffer_;
+    std::string record_; // prefixed lines, reused between writes
 };
 
 inline thread_local ThreadSafeIOStream threadSafeCout;
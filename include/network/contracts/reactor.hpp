@@ -17,6 +17,8 @@ inline bool hasEvent(IoEvent events, IoEvent check)
 
 using IoCallback = std::function<void(int fd, IoEvent events)>;
 
+// Callbacks run on the thread calling poll(). A callback may remove() its
+// own fd: the callback object stays alive until it returns.
 class IReactor
 {
 public:
@@ -1,9 +1,13 @@
 // network/impl/reactor/epoll_reactor.hpp
 #pragma once
 #include "network/contracts/reactor.hpp"
+#include <array>
+#include <cerrno>
+#include <cstdint>
 #include <stdexcept>
 #include <sys/epoll.h>
 #include <unistd.h>
+#include <unordered_map>
 
 class EpollReactor : public IReactor
 {
@@ -69,13 +73,33 @@ public:
             auto it = callbacks_.find(fd);
             if (it != callbacks_.end()) {
                 IoEvent io_ev = _fromEpollEvents(ev);
-                it->second(fd, io_ev);
+                // run it from here: if it removes its own fd, the map entry
+                // goes away but the callback lives until it returns
+                IoCallback cb = std::move(it->second);
+                try {
+                    cb(fd, io_ev);
+                }
+                catch (...) {
+                    _restore(fd, cb);
+                    throw;
+                }
+                _restore(fd, cb);
             }
         }
         return nfds;
     }
 
 private:
+    // puts a dispatched callback back unless its fd was removed (or
+    // registered again with a new callback) meanwhile
+    void _restore(int fd, IoCallback& cb)
+    {
+        auto it = callbacks_.find(fd);
+        if (it != callbacks_.end() && !it->second) {
+            it->second = std::move(cb);
+        }
+    }
+
     uint32_t _toEpollEvents(IoEvent e)
     {
         uint32_t ev = 0;
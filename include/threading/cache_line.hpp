@@ -0,0 +1,9 @@
+// include/threading/cache_line.hpp
+#pragma once
+#include <cstddef>
+
+// Alignment used to keep independently written atomics on separate cache
+// lines. std::hardware_destructive_interference_size is not used because GCC
+// warns that its value may change between compiler versions (ABI hazard in a
+// header).
+inline constexpr std::size_t kCacheLineSize = 64;
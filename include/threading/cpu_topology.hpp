@@ -0,0 +1,47 @@
+// include/threading/cpu_topology.hpp
+#pragma once
+#include <cstddef>
+#include <vector>
+
+/*
+CPUs this process may run on, with their physical core, package (socket) and
+NUMA node as reported by /sys/devices/system/cpu. Missing sysfs entries fall
+back to "every CPU is its own core on package 0, node 0".
+
+The two orders are used to place pinned workers (worker i on order[i % n]):
+
+    2 packages x 2 cores x 2 hyper-threads, cpu = p*4 + c*2 + t
+
+    spreadOrder: 0 4 2 6 1 5 3 7   alternate packages, one hyper-thread per
+                                   core before any sibling is used
+    packOrder:   0 1 2 3 4 5 6 7   fill a core, then its package, so workers
+                                   share caches
+
+Spread maximizes memory bandwidth and per-worker cache, pack keeps
+communicating workers on one socket.
+*/
+class CpuTopology
+{
+public:
+    struct Cpu
+    {
+        int id;
+        int core;    // physical core id, unique within a package
+        int package; // socket
+        int node;    // NUMA node
+    };
+
+    explicit CpuTopology(std::vector<Cpu> cpus);
+
+    // the CPUs in the calling thread's affinity mask
+    static CpuTopology detect();
+
+    const std::vector<Cpu>& cpus() const { return cpus_; }
+    size_t nodeCount() const;
+
+    std::vector<int> spreadOrder() const;
+    std::vector<int> packOrder() const;
+
+private:
+    std::vector<Cpu> cpus_; // sorted by id
+};
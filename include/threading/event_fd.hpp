@@ -0,0 +1,60 @@
+// include/threading/event_fd.hpp
+#pragma once
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+/*
+RAII wrapper around a non-blocking Linux eventfd.
+
+Lets a producer thread wake an event loop: register fd() as readable with
+the reactor, call signal() from any thread, and drain() in the callback.
+Signals coalesce, so one wake-up may stand for many signal() calls.
+*/
+class EventFd
+{
+public:
+    EventFd()
+    {
+        fd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (fd_ == -1) {
+            throw std::runtime_error(std::string("eventfd failed: ")
+                                     + std::strerror(errno));
+        }
+    }
+
+    ~EventFd() { ::close(fd_); }
+
+    EventFd(const EventFd&) = delete;
+    EventFd& operator=(const EventFd&) = delete;
+
+    int fd() const { return fd_; }
+
+    // safe from any thread
+    void signal()
+    {
+        const std::uint64_t one = 1;
+        while (::write(fd_, &one, sizeof(one)) == -1 && errno == EINTR) {
+        }
+        // EAGAIN means the counter is saturated: the fd is readable anyway
+    }
+
+    // resets the counter; returns how many signals were pending (0 if none)
+    std::uint64_t drain()
+    {
+        std::uint64_t count = 0;
+        while (::read(fd_, &count, sizeof(count)) == -1) {
+            if (errno != EINTR) {
+                return 0; // EAGAIN: nothing pending
+            }
+        }
+        return count;
+    }
+
+private:
+    int fd_{-1};
+};
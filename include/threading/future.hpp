@@ -0,0 +1,139 @@
+// include/threading/future.hpp
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+/*
+Lightweight one-shot future returned by WorkerPool::submit().
+
+The shared state is one allocation holding the result (or the exception)
+and a 32-bit ready flag. Waiting uses std::atomic::wait, so there is no
+mutex or condition variable, and setting the value only issues a wake-up
+when someone is actually waiting.
+
+    Future<int> f = pool.submit([](int x) { return x * 2; }, 21);
+    int v = f.get();     // 42, or rethrows what the job threw
+*/
+namespace future_detail
+{
+
+template <typename T> struct Storage
+{
+    std::optional<T> value;
+};
+
+template <> struct Storage<void>
+{
+};
+
+} // namespace future_detail
+
+template <typename T> class FutureState
+{
+public:
+    template <typename F, typename... Args> void run(F& fn, Args&... args)
+    {
+        try {
+            if constexpr (std::is_void_v<T>) {
+                std::invoke(fn, args...);
+            }
+            else {
+                storage_.value.emplace(std::invoke(fn, args...));
+            }
+        }
+        catch (...) {
+            error_ = std::current_exception();
+        }
+        _publish();
+    }
+
+    bool ready() const { return state_.load(std::memory_order_acquire) != 0; }
+
+    void wait() const
+    {
+        if (ready()) {
+            return;
+        }
+        // seq_cst on both sides: either _publish sees us counted or we see
+        // the ready flag
+        waiters_.fetch_add(1);
+        while (state_.load() == 0) {
+            state_.wait(0, std::memory_order_acquire);
+        }
+        waiters_.fetch_sub(1);
+    }
+
+    T take()
+    {
+        wait();
+        if (error_) {
+            std::rethrow_exception(error_);
+        }
+        if constexpr (!std::is_void_v<T>) {
+            return std::move(*storage_.value);
+        }
+    }
+
+private:
+    void _publish()
+    {
+        state_.store(1);
+        if (waiters_.load() != 0) {
+            state_.notify_all();
+        }
+    }
+
+    mutable std::atomic<std::uint32_t> state_{0};
+    mutable std::atomic<std::uint32_t> waiters_{0};
+    future_detail::Storage<T> storage_;
+    std::exception_ptr error_;
+};
+
+template <typename T> class Future
+{
+public:
+    Future() = default;
+    explicit Future(std::shared_ptr<FutureState<T>> state) :
+        state_(std::move(state))
+    {
+    }
+
+    Future(Future&&) noexcept = default;
+    Future& operator=(Future&&) noexcept = default;
+    Future(const Future&) = delete;
+    Future& operator=(const Future&) = delete;
+
+    bool valid() const { return state_ != nullptr; }
+
+    bool ready() const { return _state().ready(); }
+
+    void wait() const { _state().wait(); }
+
+    // blocks until the job ran; one call only, the future is empty after
+    T get()
+    {
+        auto state = std::move(state_);
+        if (!state) {
+            throw std::logic_error("Future has no state");
+        }
+        return state->take();
+    }
+
+private:
+    FutureState<T>& _state() const
+    {
+        if (!state_) {
+            throw std::logic_error("Future has no state");
+        }
+        return *state_;
+    }
+
+    std::shared_ptr<FutureState<T>> state_;
+};
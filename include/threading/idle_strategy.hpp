@@ -0,0 +1,88 @@
+// include/threading/idle_strategy.hpp
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+/*
+Back-off for a thread that ran out of work: spin, then yield, then park.
+
+Parking costs a futex wake-up of tens of microseconds on the next job, so a
+worker that expects work soon should stay awake. How long is worth it
+depends on the traffic, so the budget follows an exponentially weighted
+average of the idle gaps seen so far:
+
+    gap average <= maxSpin:  stay awake 2 x average (capped at maxSpin)
+    gap average >  maxSpin:  park right away, spinning would be wasted
+
+Within the budget the first half spins with the CPU's pause instruction
+(cheap for the sibling hyper-thread), the second half yields the core.
+
+    IdleStrategy idle(20us);
+    auto since = IdleStrategy::Clock::now();
+    while (!(job = tryTake()) && idle.step(since)) {}
+    if (!job) { park(); job = take(); }
+    idle.record(IdleStrategy::Clock::now() - since);
+
+maxSpin 0 disables spinning: step() is always false.
+*/
+inline void cpuRelax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+class IdleStrategy
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr int kPauseBatch = 16;
+
+    explicit IdleStrategy(std::chrono::nanoseconds maxSpin = {}) :
+        maxSpin_(maxSpin), budget_(maxSpin)
+    {
+    }
+
+    std::chrono::nanoseconds budget() const { return budget_; }
+    std::chrono::nanoseconds averageGap() const { return average_; }
+
+    // one back-off step of the idle period that started at `since`; false
+    // once the budget is spent and the caller should park
+    bool step(Clock::time_point since) const
+    {
+        const auto elapsed = Clock::now() - since;
+        if (elapsed >= budget_) {
+            return false;
+        }
+        if (elapsed < budget_ / 2) {
+            for (int i = 0; i < kPauseBatch; ++i) {
+                cpuRelax();
+            }
+        }
+        else {
+            std::this_thread::yield();
+        }
+        return true;
+    }
+
+    // the idle period ended after `gap` (spinning and parking included)
+    void record(std::chrono::nanoseconds gap)
+    {
+        if (maxSpin_.count() == 0) {
+            return;
+        }
+        // average += (gap - average) / 8
+        average_ += (gap - average_) / 8;
+        budget_ = average_ <= maxSpin_ ? std::min(maxSpin_, 2 * average_)
+                                       : std::chrono::nanoseconds{0};
+    }
+
+private:
+    std::chrono::nanoseconds maxSpin_;
+    std::chrono::nanoseconds budget_;
+    std::chrono::nanoseconds average_{0};
+};
@@ -0,0 +1,159 @@
+// include/threading/job.hpp
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/*
+Move-only, type-erased void() callable with small-buffer storage.
+
+Callables up to kInlineSize bytes (a lambda capturing a handful of
+references or values, or a std::function) are stored inside the Job
+itself, so creating, queueing and running one allocates nothing:
+
+    [ storage (48 bytes, max-aligned) | ops_ | queuedAt_ ]  sizeof == 64
+
+queuedAt_ fills what would otherwise be padding: WorkerPool stamps it on
+enqueue to measure how long jobs wait. It travels with the job on moves.
+
+Larger, over-aligned, or not-nothrow-movable callables are heap allocated
+once and only the pointer moves. Unlike std::function, a Job can hold
+move-only captures (std::unique_ptr, std::promise, ...).
+*/
+class Job
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr std::size_t kInlineSize = 48;
+
+    Job() noexcept = default;
+
+    template <typename F>
+        requires(!std::is_same_v<std::remove_cvref_t<F>, Job>
+                 && std::is_invocable_v<std::decay_t<F>&>)
+    Job(F&& f) // NOLINT: implicit, like std::function
+    {
+        using Fn = std::decay_t<F>;
+        if constexpr (_fitsInline<Fn>()) {
+            ::new (static_cast<void*>(storage_)) Fn(std::forward<F>(f));
+            ops_ = &kInlineOps<Fn>;
+        }
+        else {
+            ::new (static_cast<void*>(storage_)) Fn*(
+                new Fn(std::forward<F>(f)));
+            ops_ = &kHeapOps<Fn>;
+        }
+    }
+
+    Job(Job&& other) noexcept :
+        ops_(other.ops_), queuedAt_(other.queuedAt_)
+    {
+        if (ops_ != nullptr) {
+            ops_->move(storage_, other.storage_);
+            other.ops_ = nullptr;
+        }
+    }
+
+    Job& operator=(Job&& other) noexcept
+    {
+        if (this != &other) {
+            reset();
+            if (other.ops_ != nullptr) {
+                other.ops_->move(storage_, other.storage_);
+                ops_ = other.ops_;
+                other.ops_ = nullptr;
+            }
+            queuedAt_ = other.queuedAt_;
+        }
+        return *this;
+    }
+
+    Job(const Job&) = delete;
+    Job& operator=(const Job&) = delete;
+
+    ~Job() { reset(); }
+
+    void operator()() { ops_->invoke(storage_); }
+
+    explicit operator bool() const noexcept { return ops_ != nullptr; }
+
+    void reset() noexcept
+    {
+        if (ops_ != nullptr) {
+            ops_->destroy(storage_);
+            ops_ = nullptr;
+        }
+    }
+
+    Clock::time_point queuedAt() const noexcept { return queuedAt_; }
+    void setQueuedAt(Clock::time_point t) noexcept { queuedAt_ = t; }
+
+    // true when a callable of type F would be stored without allocating
+    template <typename F> static constexpr bool storesInline()
+    {
+        return _fitsInline<std::decay_t<F>>();
+    }
+
+private:
+    struct Ops
+    {
+        void (*invoke)(void* self);
+        // move-constructs into dst and destroys src
+        void (*move)(void* dst, void* src) noexcept;
+        void (*destroy)(void* self) noexcept;
+    };
+
+    template <typename Fn> static constexpr bool _fitsInline()
+    {
+        return sizeof(Fn) <= kInlineSize
+               && alignof(Fn) <= alignof(std::max_align_t)
+               && std::is_nothrow_move_constructible_v<Fn>;
+    }
+
+    template <typename Fn> static Fn* _inline(void* p)
+    {
+        return std::launder(static_cast<Fn*>(p));
+    }
+
+    template <typename Fn> static Fn*& _heap(void* p)
+    {
+        return *std::launder(static_cast<Fn**>(p));
+    }
+
+    template <typename Fn>
+    static constexpr Ops kInlineOps{
+        [](void* self) {
+            std::invoke(*_inline<Fn>(self));
+        },
+        [](void* dst, void* src) noexcept {
+            ::new (dst) Fn(std::move(*_inline<Fn>(src)));
+            _inline<Fn>(src)->~Fn();
+        },
+        [](void* self) noexcept {
+            _inline<Fn>(self)->~Fn();
+        },
+    };
+
+    template <typename Fn>
+    static constexpr Ops kHeapOps{
+        [](void* self) {
+            std::invoke(*_heap<Fn>(self));
+        },
+        [](void* dst, void* src) noexcept {
+            ::new (dst) Fn*(_heap<Fn>(src));
+        },
+        [](void* self) noexcept {
+            delete _heap<Fn>(self);
+        },
+    };
+
+private:
+    alignas(std::max_align_t) std::byte storage_[kInlineSize];
+    const Ops* ops_{nullptr};
+    Clock::time_point queuedAt_{};
+};
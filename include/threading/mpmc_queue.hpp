@@ -0,0 +1,343 @@
+// include/threading/mpmc_queue.hpp
+#pragma once
+#include "cache_line.hpp"
+#include <atomic>
+#include <bit>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+/*
+Bounded multi-producer / multi-consumer ring queue (D. Vyukov's design).
+
+Every cell carries a sequence number that tells producers and consumers
+whose turn it is, so a push or pop is one CAS on the shared position plus
+one release store on the cell; no lock is taken.
+
+    cell i, lap n:   sequence == pos          -> free, producer of pos may fill
+                     sequence == pos + 1      -> full, consumer of pos may take
+                     sequence == pos + cap    -> freed, next lap may fill
+
+    enqueuePos_ (own cache line)    dequeuePos_ (own cache line)
+         |                               |
+    [ s | s | s | s | s | s | s | s ] capacity rounded up to a power of two
+
+MPMCQueue only offers try_push / try_pop. BlockingMPMCQueue wraps it with
+push / pop that spin briefly and then park on a condition variable, only
+while the ring is full (push) or empty (pop); the fast path never touches
+the mutex. close() has the ThreadSafeQueue meaning: pushes throw, pops drain
+what is left and then return std::nullopt. Pushes in flight are counted, so
+a push that passed the closed check before close() still lands before pop()
+reports the queue drained.
+
+Elements are moved in and out, so TType must be nothrow move constructible;
+copies are made before a slot is claimed, which keeps the queue unchanged
+when a copy constructor throws.
+*/
+template <typename TType> class MPMCQueue
+{
+    static_assert(std::is_nothrow_move_constructible_v<TType>,
+                  "MPMCQueue elements must be nothrow move constructible");
+
+public:
+    explicit MPMCQueue(std::size_t capacity) :
+        capacity_(_checkedCapacity(capacity)),
+        mask_(capacity_ - 1),
+        cells_(std::make_unique<Cell[]>(capacity_))
+    {
+        for (std::size_t i = 0; i < capacity_; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~MPMCQueue()
+    {
+        while (try_pop()) {
+        }
+    }
+
+    MPMCQueue(const MPMCQueue&) = delete;
+    MPMCQueue& operator=(const MPMCQueue&) = delete;
+
+    bool try_push(const TType& element)
+    {
+        TType copy(element);
+        return try_push(std::move(copy));
+    }
+
+    // element is only moved from when true is returned
+    bool try_push(TType&& element)
+    {
+        std::size_t pos = 0;
+        Cell* cell = _claimForPush(pos);
+        if (cell == nullptr) {
+            return false;
+        }
+        ::new (cell->storage) TType(std::move(element));
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    template <typename... Args> bool try_emplace(Args&&... args)
+    {
+        return try_push(TType(std::forward<Args>(args)...));
+    }
+
+    std::optional<TType> try_pop()
+    {
+        std::size_t pos = dequeuePos_.load(std::memory_order_relaxed);
+        Cell* cell = nullptr;
+        while (true) {
+            cell = &cells_[pos & mask_];
+            const std::size_t seq =
+                cell->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::intptr_t>(seq)
+                              - static_cast<std::intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeuePos_.compare_exchange_weak(
+                        pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            }
+            else if (diff < 0) {
+                return std::nullopt; // empty
+            }
+            else {
+                pos = dequeuePos_.load(std::memory_order_relaxed);
+            }
+        }
+        TType* slot = std::launder(reinterpret_cast<TType*>(cell->storage));
+        std::optional<TType> element(std::move(*slot));
+        slot->~TType();
+        cell->sequence.store(pos + capacity_, std::memory_order_release);
+        return element;
+    }
+
+    std::size_t capacity() const { return capacity_; }
+
+    // snapshot only, may be stale by the time the caller looks at it.
+    // Claimed-but-unpublished slots count as occupied.
+    std::size_t size_approx() const
+    {
+        const std::size_t deq = dequeuePos_.load(std::memory_order_relaxed);
+        const std::size_t enq = enqueuePos_.load(std::memory_order_relaxed);
+        return enq > deq ? enq - deq : 0;
+    }
+
+private:
+    struct Cell
+    {
+        std::atomic<std::size_t> sequence{0};
+        alignas(TType) std::byte storage[sizeof(TType)];
+    };
+
+    static std::size_t _checkedCapacity(std::size_t capacity)
+    {
+        if (capacity == 0) {
+            throw std::invalid_argument("MPMCQueue capacity must be positive");
+        }
+        return std::bit_ceil(capacity);
+    }
+
+    Cell* _claimForPush(std::size_t& pos)
+    {
+        pos = enqueuePos_.load(std::memory_order_relaxed);
+        while (true) {
+            Cell* cell = &cells_[pos & mask_];
+            const std::size_t seq =
+                cell->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::intptr_t>(seq)
+                              - static_cast<std::intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueuePos_.compare_exchange_weak(
+                        pos, pos + 1, std::memory_order_relaxed)) {
+                    return cell;
+                }
+            }
+            else if (diff < 0) {
+                return nullptr; // full
+            }
+            else {
+                pos = enqueuePos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+private:
+    const std::size_t capacity_;
+    const std::size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+    alignas(kCacheLineSize) std::atomic<std::size_t> enqueuePos_{0};
+    // the class alignment also keeps whatever follows off this line
+    alignas(kCacheLineSize) std::atomic<std::size_t> dequeuePos_{0};
+};
+
+template <typename TType> class BlockingMPMCQueue
+{
+public:
+    // attempts made on the lock-free path before a thread parks
+    static constexpr int kSpinTries = 64;
+
+    explicit BlockingMPMCQueue(std::size_t capacity) : queue_(capacity) {}
+
+    // blocks while the queue is full; throws once the queue is closed
+    void push(const TType& element)
+    {
+        TType copy(element);
+        push(std::move(copy));
+    }
+
+    void push(TType&& element)
+    {
+        int spins = 0;
+        while (true) {
+            if (_pushOnce(element)) {
+                _wake(popWaiters_, notEmpty_);
+                return;
+            }
+            if (++spins < kSpinTries) {
+                std::this_thread::yield();
+                continue;
+            }
+            _park(pushWaiters_, notFull_, [this]() {
+                return queue_.size_approx() < queue_.capacity();
+            });
+        }
+    }
+
+    // blocks while the queue is empty; nullopt once closed and drained
+    std::optional<TType> pop()
+    {
+        int spins = 0;
+        while (true) {
+            if (auto element = queue_.try_pop()) {
+                _wake(pushWaiters_, notFull_);
+                return element;
+            }
+            if (closed_.load()) {
+                if (pushing_.load() == 0 && queue_.size_approx() == 0) {
+                    return std::nullopt;
+                }
+                // a push that started before close() is about to land
+                std::this_thread::yield();
+                continue;
+            }
+            if (++spins < kSpinTries) {
+                std::this_thread::yield();
+                continue;
+            }
+            _park(popWaiters_, notEmpty_, [this]() {
+                return queue_.size_approx() != 0;
+            });
+        }
+    }
+
+    bool try_push(const TType& element)
+    {
+        TType copy(element);
+        return try_push(std::move(copy));
+    }
+
+    bool try_push(TType&& element)
+    {
+        if (!_pushOnce(element)) {
+            return false;
+        }
+        _wake(popWaiters_, notEmpty_);
+        return true;
+    }
+
+    std::optional<TType> try_pop()
+    {
+        auto element = queue_.try_pop();
+        if (element) {
+            _wake(pushWaiters_, notFull_);
+        }
+        return element;
+    }
+
+    // a push in flight counts as an element: it may still land
+    bool empty() const
+    {
+        return pushing_.load() == 0 && queue_.size_approx() == 0;
+    }
+
+    std::size_t size_approx() const { return queue_.size_approx(); }
+
+    std::size_t capacity() const { return queue_.capacity(); }
+
+    void close()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            closed_.store(true);
+        }
+        notEmpty_.notify_all();
+        notFull_.notify_all();
+    }
+
+private:
+    // one attempt, counted in pushing_ so pop() does not report the queue
+    // drained while it is in flight; throws once closed
+    bool _pushOnce(TType& element)
+    {
+        // seq_cst against close(): either close() comes first and we see
+        // it, or pop() sees us counted after it sees closed_
+        pushing_.fetch_add(1);
+        if (closed_.load()) {
+            pushing_.fetch_sub(1);
+            throw std::runtime_error(
+                "Cannot push to a closed BlockingMPMCQueue.");
+        }
+        const bool pushed = queue_.try_push(std::move(element));
+        pushing_.fetch_sub(1);
+        return pushed;
+    }
+
+    template <typename Ready>
+    void _park(std::atomic<int>& waiters,
+               std::condition_variable& cv,
+               Ready ready)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        waiters.fetch_add(1);
+        // pairs with the fence in _wake: either the waker sees us counted or
+        // we see its element
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        cv.wait(lock, [&]() {
+            return ready() || closed_.load(std::memory_order_relaxed);
+        });
+        waiters.fetch_sub(1);
+    }
+
+    void _wake(std::atomic<int>& waiters, std::condition_variable& cv)
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiters.load(std::memory_order_relaxed) == 0) {
+            return;
+        }
+        {
+            // a parking thread holds the mutex until it is inside wait()
+            std::lock_guard<std::mutex> lock(mutex_);
+        }
+        cv.notify_one();
+    }
+
+private:
+    MPMCQueue<TType> queue_;
+    std::atomic<bool> closed_{false};
+    std::atomic<int> pushing_{0};
+    std::atomic<int> popWaiters_{0};
+    std::atomic<int> pushWaiters_{0};
+    std::mutex mutex_;
+    std::condition_variable notEmpty_;
+    std::condition_variable notFull_;
+};
@@ -0,0 +1,226 @@
+// include/threading/parallel.hpp
+#pragma once
+#include "worker_pool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <optional>
+#include <ranges>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/*
+Data-parallel loops on a WorkerPool.
+
+The index range is cut into chunks of `grain` iterations (grain 0 picks
+about 8 chunks per worker). The chunk range is split recursively: each
+split pushes its right half as a job and keeps the left half, so under
+Options::workStealing the halves land in the splitting worker's deque and
+idle workers steal the biggest pieces first.
+
+    [0 ........................ n)
+    [0 ....... n/2)  job:[n/2 ....... n)
+    [0 .. n/4) job:[n/4 .. n/2)   ...
+
+The calling thread runs the leftmost path itself and then helps with queued
+jobs (WorkerPool::runOneJob) until every chunk is done, so it never sits
+idle and nested loops inside a job cannot deadlock the pool.
+
+parallel_reduce folds each chunk from its first element and combines the
+chunk results with init in index order: combine only has to be associative,
+not commutative. The first exception thrown by fn/map, or by the pool when
+it refuses a half (stopped), cancels the chunks not started yet and is
+rethrown to the caller once every queued half has finished.
+
+    parallel_for(pool, 0, tiles.size(), 4, [&](size_t i) { render(tiles[i]); });
+    auto sum = parallel_reduce(pool, values, 0.0,
+                               [](double v) { return v * v; },
+                               std::plus<>{});
+*/
+namespace parallel_detail
+{
+
+struct Join
+{
+    std::atomic<size_t> pending{0};
+    std::atomic<bool> failed{false};
+    std::exception_ptr error;
+
+    void fail()
+    {
+        if (!failed.exchange(true)) {
+            error = std::current_exception();
+        }
+    }
+};
+
+inline size_t chunkSize(const WorkerPool& pool, size_t n, size_t grain)
+{
+    if (grain != 0) {
+        return grain;
+    }
+    const size_t target = std::max<size_t>(1, pool.workerCount()) * 8;
+    return std::max<size_t>(1, n / target);
+}
+
+// runs leaf(c) for every chunk c in [b, e), splitting off right halves
+template <typename Leaf>
+void split(WorkerPool& pool, Join& join, size_t b, size_t e, Leaf& leaf)
+{
+    while (e - b > 1) {
+        const size_t mid = b + (e - b) / 2;
+        join.pending.fetch_add(1);
+        try {
+            pool.addJob([&pool, &join, &leaf, mid, e]() {
+                try {
+                    split(pool, join, mid, e, leaf);
+                }
+                catch (...) {
+                    join.fail();
+                }
+                join.pending.fetch_sub(1, std::memory_order_release);
+            });
+        }
+        catch (...) {
+            // never queued: nobody else will count it down
+            join.pending.fetch_sub(1, std::memory_order_release);
+            throw;
+        }
+        e = mid;
+    }
+    if (join.failed.load(std::memory_order_relaxed)) {
+        return;
+    }
+    try {
+        leaf(b);
+    }
+    catch (...) {
+        join.fail();
+    }
+}
+
+template <typename Leaf>
+void run(WorkerPool& pool, size_t chunks, Leaf& leaf)
+{
+    if (chunks == 0) {
+        return;
+    }
+    Join join;
+    try {
+        split(pool, join, 0, chunks, leaf);
+    }
+    catch (...) {
+        // halves queued before the failure still use join and leaf
+        join.fail();
+    }
+    while (join.pending.load(std::memory_order_acquire) != 0) {
+        if (!pool.runOneJob()) {
+            std::this_thread::yield();
+        }
+    }
+    if (join.error) {
+        std::rethrow_exception(join.error);
+    }
+}
+
+} // namespace parallel_detail
+
+// fn(i) for every i in [begin, end)
+template <typename Fn>
+void parallel_for(
+    WorkerPool& pool, size_t begin, size_t end, size_t grain, Fn&& fn)
+{
+    if (end <= begin) {
+        return;
+    }
+    const size_t n = end - begin;
+    const size_t chunk = parallel_detail::chunkSize(pool, n, grain);
+    auto leaf = [&](size_t c) {
+        const size_t first = begin + c * chunk;
+        const size_t last = std::min(end, first + chunk);
+        for (size_t i = first; i < last; ++i) {
+            fn(i);
+        }
+    };
+    parallel_detail::run(pool, (n + chunk - 1) / chunk, leaf);
+}
+
+// fn(element) for every element of a random-access range
+template <std::ranges::random_access_range Range, typename Fn>
+    requires std::ranges::sized_range<Range>
+void parallel_for(WorkerPool& pool, Range&& range, size_t grain, Fn&& fn)
+{
+    auto first = std::ranges::begin(range);
+    parallel_for(pool,
+                 0,
+                 static_cast<size_t>(std::ranges::size(range)),
+                 grain,
+                 [&](size_t i) {
+                     fn(first[static_cast<std::ptrdiff_t>(i)]);
+                 });
+}
+
+// combine(init, map(begin), ..., map(end - 1)) for an associative combine
+template <typename T, typename Map, typename Combine>
+T parallel_reduce(WorkerPool& pool,
+                  size_t begin,
+                  size_t end,
+                  T init,
+                  Map&& map,
+                  Combine&& combine,
+                  size_t grain = 0)
+{
+    if (end <= begin) {
+        return init;
+    }
+    const size_t n = end - begin;
+    const size_t chunk = parallel_detail::chunkSize(pool, n, grain);
+    const size_t chunks = (n + chunk - 1) / chunk;
+    std::vector<std::optional<T>> partial(chunks);
+
+    auto leaf = [&](size_t c) {
+        const size_t first = begin + c * chunk;
+        const size_t last = std::min(end, first + chunk);
+        T acc = map(first);
+        for (size_t i = first + 1; i < last; ++i) {
+            acc = combine(std::move(acc), map(i));
+        }
+        partial[c].emplace(std::move(acc));
+    };
+    parallel_detail::run(pool, chunks, leaf);
+
+    T result = std::move(init);
+    for (auto& p : partial) {
+        result = combine(std::move(result), std::move(*p));
+    }
+    return result;
+}
+
+template <std::ranges::random_access_range Range,
+          typename T,
+          typename Map,
+          typename Combine>
+    requires std::ranges::sized_range<Range>
+T parallel_reduce(WorkerPool& pool,
+                  Range&& range,
+                  T init,
+                  Map&& map,
+                  Combine&& combine,
+                  size_t grain = 0)
+{
+    auto first = std::ranges::begin(range);
+    return parallel_reduce(
+        pool,
+        0,
+        static_cast<size_t>(std::ranges::size(range)),
+        std::move(init),
+        [&](size_t i) {
+            return map(first[static_cast<std::ptrdiff_t>(i)]);
+        },
+        combine,
+        grain);
+}
@@ -0,0 +1,127 @@
+// include/threading/pool_metrics.hpp
+#pragma once
+#include "cache_line.hpp"
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+Instrumentation for WorkerPool (Options::metrics).
+
+Every worker records into its own cache-line aligned WorkerStats block, so
+recording is a few uncontended relaxed increments and workers never share a
+written line. WorkerPool::metrics() sums the blocks into a PoolMetrics
+snapshot; reading never stops the workers and the snapshot is approximate
+while jobs are running.
+
+Durations go into log2 buckets of nanoseconds: bucket b holds [2^(b-1),
+2^b), so percentiles are exact to a factor of two, which is plenty to size
+a pool or spot a stall:
+
+    auto m = pool.metrics();
+    if (m.queueLatency.percentile(0.99) > 2ms) { ... }   // jobs wait
+    for (auto& w : m.workers) { w.busy / (w.busy + w.idle); }
+*/
+class LatencyHistogram
+{
+public:
+    static constexpr size_t kBuckets = 64;
+
+    struct Snapshot
+    {
+        std::array<std::uint64_t, kBuckets> buckets{};
+
+        std::uint64_t count() const
+        {
+            std::uint64_t n = 0;
+            for (auto b : buckets) {
+                n += b;
+            }
+            return n;
+        }
+
+        // upper bound of the bucket holding the p-quantile (0 <= p <= 1);
+        // 0 when nothing was recorded
+        std::chrono::nanoseconds percentile(double p) const
+        {
+            const std::uint64_t n = count();
+            if (n == 0) {
+                return std::chrono::nanoseconds{0};
+            }
+            auto rank = static_cast<std::uint64_t>(p * static_cast<double>(n));
+            rank = rank < n ? rank : n - 1;
+            std::uint64_t seen = 0;
+            for (size_t b = 0; b < kBuckets; ++b) {
+                seen += buckets[b];
+                if (seen > rank) {
+                    return _upperBound(b);
+                }
+            }
+            return _upperBound(kBuckets - 1);
+        }
+
+        void merge(const Snapshot& other)
+        {
+            for (size_t b = 0; b < kBuckets; ++b) {
+                buckets[b] += other.buckets[b];
+            }
+        }
+    };
+
+    void record(std::chrono::nanoseconds d) noexcept
+    {
+        const std::int64_t ns = d.count() > 0 ? d.count() : 0;
+        const size_t b = std::bit_width(static_cast<std::uint64_t>(ns));
+        buckets_[b < kBuckets ? b : kBuckets - 1].fetch_add(
+            1, std::memory_order_relaxed);
+    }
+
+    void addTo(Snapshot& out) const
+    {
+        for (size_t b = 0; b < kBuckets; ++b) {
+            out.buckets[b] += buckets_[b].load(std::memory_order_relaxed);
+        }
+    }
+
+private:
+    static std::chrono::nanoseconds _upperBound(size_t bucket)
+    {
+        const size_t shift = bucket < 63 ? bucket : 62;
+        return std::chrono::nanoseconds{
+            static_cast<std::int64_t>(std::uint64_t{1} << shift)};
+    }
+
+    std::array<std::atomic<std::uint64_t>, kBuckets> buckets_{};
+};
+
+// written by one worker (or, for the shared slot, by helping threads)
+struct alignas(kCacheLineSize) WorkerStats
+{
+    std::atomic<std::uint64_t> jobs{0};
+    std::atomic<std::int64_t> busyNs{0};
+    std::atomic<std::int64_t> idleNs{0};
+    LatencyHistogram queueLatency; // enqueue to start
+    LatencyHistogram runTime;
+};
+
+struct PoolMetrics
+{
+    struct Worker
+    {
+        std::uint64_t jobs = 0;
+        std::chrono::nanoseconds busy{0}; // running jobs
+        std::chrono::nanoseconds idle{0}; // spinning or parked
+        bool live = false;                // thread currently running
+    };
+
+    LatencyHistogram::Snapshot queueLatency;
+    LatencyHistogram::Snapshot runTime;
+    std::vector<Worker> workers; // one per worker slot
+    std::uint64_t helperJobs = 0; // run by threads helping via runOneJob
+    size_t queueDepth = 0;        // jobs waiting to start
+    size_t pending = 0;           // waiting or running
+};
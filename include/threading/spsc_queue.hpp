@@ -0,0 +1,329 @@
+// include/threading/spsc_queue.hpp
+#pragma once
+#include "cache_line.hpp"
+#include <atomic>
+#include <bit>
+#include <condition_variable>
+#include <cstddef>
+#include <linux/membarrier.h>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <sys/syscall.h>
+#include <thread>
+#include <type_traits>
+#include <unistd.h>
+#include <utility>
+
+/*
+Bounded single-producer / single-consumer ring queue.
+
+Exactly one thread pushes and exactly one thread pops. Each side owns one
+index and keeps a private copy of the other side's index, so the shared
+cache line is only read again when the cached value says the ring looks
+full (producer) or empty (consumer):
+
+    producer line: tail_  cachedHead_  writeTail_
+    consumer line: head_  cachedTail_
+    ring:          [ . . x x x x . . ]   head_ <= x < tail_
+
+try_push / try_pop are wait-free. Batched publish: stage() writes elements
+without making them visible and publish() releases the whole batch with a
+single store (and at most one wake-up of a parked consumer).
+
+push / pop block on a full / empty ring: they spin briefly and then park on
+a condition variable, which is only touched while parking or while the
+other side is parked. The wake-up handshake (index store then flag load on
+one side, flag store then index load on the other) needs a full barrier on
+both sides; try_pop / publish run on every element, so the whole cost goes
+to the side that parks: it issues membarrier(), which acts as a fence on
+every running thread of the process, and the fast paths only need a
+compiler barrier before their relaxed flag load. Kernels without
+MEMBARRIER_CMD_PRIVATE_EXPEDITED get a seq_cst fence on both sides. close()
+has the ThreadSafeQueue meaning: pushes throw, pop drains the remaining
+elements and then returns std::nullopt. Either side may call close().
+*/
+namespace spsc_detail
+{
+
+// registers the process once; false when the kernel cannot do it
+inline bool asymmetricFenceAvailable()
+{
+    static const bool available =
+        ::syscall(SYS_membarrier,
+                  MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED,
+                  0,
+                  0)
+        == 0;
+    return available;
+}
+
+} // namespace spsc_detail
+
+template <typename TType> class SPSCQueue
+{
+    static_assert(std::is_nothrow_move_constructible_v<TType>,
+                  "SPSCQueue elements must be nothrow move constructible");
+
+public:
+    // attempts made on the wait-free path before a thread parks
+    static constexpr int kSpinTries = 64;
+
+    explicit SPSCQueue(std::size_t capacity) :
+        capacity_(_checkedCapacity(capacity)),
+        mask_(capacity_ - 1),
+        slots_(std::make_unique<Slot[]>(capacity_)),
+        asymmetric_(spsc_detail::asymmetricFenceAvailable())
+    {
+    }
+
+    ~SPSCQueue()
+    {
+        // staged elements were never published but are still owned here
+        for (std::size_t i = head_.load(std::memory_order_relaxed);
+             i != writeTail_;
+             ++i) {
+            _at(i)->~TType();
+        }
+    }
+
+    SPSCQueue(const SPSCQueue&) = delete;
+    SPSCQueue& operator=(const SPSCQueue&) = delete;
+
+    // producer side ---------------------------------------------------------
+
+    // writes the element without publishing it; false when the ring is full
+    bool try_stage(TType&& element)
+    {
+        _checkOpen();
+        const std::size_t t = writeTail_;
+        if (t - cachedHead_ == capacity_) {
+            cachedHead_ = head_.load(std::memory_order_acquire);
+            if (t - cachedHead_ == capacity_) {
+                return false;
+            }
+        }
+        ::new (slots_[t & mask_].storage) TType(std::move(element));
+        writeTail_ = t + 1;
+        return true;
+    }
+
+    bool try_stage(const TType& element)
+    {
+        TType copy(element);
+        return try_stage(std::move(copy));
+    }
+
+    // makes every staged element visible to the consumer
+    void publish()
+    {
+        if (tail_.load(std::memory_order_relaxed) == writeTail_) {
+            return;
+        }
+        tail_.store(writeTail_, std::memory_order_release);
+        _wake(consumerParked_);
+    }
+
+    bool try_push(TType&& element)
+    {
+        if (!try_stage(std::move(element))) {
+            return false;
+        }
+        publish();
+        return true;
+    }
+
+    bool try_push(const TType& element)
+    {
+        TType copy(element);
+        return try_push(std::move(copy));
+    }
+
+    template <typename... Args> bool try_emplace(Args&&... args)
+    {
+        return try_push(TType(std::forward<Args>(args)...));
+    }
+
+    // blocks while the ring is full; throws once the queue is closed
+    void push(TType&& element)
+    {
+        int spins = 0;
+        while (!try_push(std::move(element))) {
+            if (++spins < kSpinTries) {
+                std::this_thread::yield();
+                continue;
+            }
+            _park(producerParked_, [this]() {
+                return writeTail_ - head_.load(std::memory_order_acquire)
+                       < capacity_;
+            });
+        }
+    }
+
+    void push(const TType& element)
+    {
+        TType copy(element);
+        push(std::move(copy));
+    }
+
+    // consumer side ---------------------------------------------------------
+
+    std::optional<TType> try_pop()
+    {
+        const std::size_t h = head_.load(std::memory_order_relaxed);
+        if (h == cachedTail_) {
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+            if (h == cachedTail_) {
+                return std::nullopt;
+            }
+        }
+        TType* slot = _at(h);
+        std::optional<TType> element(std::move(*slot));
+        slot->~TType();
+        head_.store(h + 1, std::memory_order_release);
+        _wake(producerParked_);
+        return element;
+    }
+
+    // blocks while the ring is empty; nullopt once closed and drained
+    std::optional<TType> pop()
+    {
+        int spins = 0;
+        while (true) {
+            if (auto element = try_pop()) {
+                return element;
+            }
+            if (closed_.load(std::memory_order_acquire)) {
+                // elements published before close() are still delivered
+                return try_pop();
+            }
+            if (++spins < kSpinTries) {
+                std::this_thread::yield();
+                continue;
+            }
+            _park(consumerParked_, [this]() {
+                return tail_.load(std::memory_order_acquire)
+                       != head_.load(std::memory_order_relaxed);
+            });
+        }
+    }
+
+    // either side --------------------------------------------------------
+
+    void close()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            closed_.store(true, std::memory_order_release);
+        }
+        cv_.notify_all();
+    }
+
+    bool closed() const { return closed_.load(std::memory_order_acquire); }
+
+    std::size_t capacity() const { return capacity_; }
+
+    // published elements; exact only when called by one of the two sides
+    // while the other is idle
+    std::size_t size_approx() const
+    {
+        const std::size_t h = head_.load(std::memory_order_acquire);
+        const std::size_t t = tail_.load(std::memory_order_acquire);
+        return t - h;
+    }
+
+private:
+    struct Slot
+    {
+        alignas(TType) std::byte storage[sizeof(TType)];
+    };
+
+    static std::size_t _checkedCapacity(std::size_t capacity)
+    {
+        if (capacity == 0) {
+            throw std::invalid_argument("SPSCQueue capacity must be positive");
+        }
+        return std::bit_ceil(capacity);
+    }
+
+    TType* _at(std::size_t index)
+    {
+        return std::launder(
+            reinterpret_cast<TType*>(slots_[index & mask_].storage));
+    }
+
+    void _checkOpen() const
+    {
+        if (closed_.load(std::memory_order_relaxed)) {
+            throw std::runtime_error("Cannot push to a closed SPSCQueue.");
+        }
+    }
+
+    template <typename Ready> void _park(std::atomic<bool>& parked, Ready ready)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        parked.store(true, std::memory_order_relaxed);
+        // pairs with _wake: either the other side sees the flag or we see
+        // its index update
+        _heavyFence();
+        cv_.wait(lock, [&]() {
+            return ready() || closed_.load(std::memory_order_relaxed);
+        });
+        parked.store(false, std::memory_order_relaxed);
+    }
+
+    void _wake(std::atomic<bool>& parked)
+    {
+        // our index store stays before the flag load: the parking side's
+        // membarrier() supplies the hardware half of the fence
+        if (asymmetric_) {
+            std::atomic_signal_fence(std::memory_order_seq_cst);
+        }
+        else {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+        if (!parked.load(std::memory_order_relaxed)) {
+            return;
+        }
+        {
+            // the parking side holds the mutex until it is inside wait()
+            std::lock_guard<std::mutex> lock(mutex_);
+        }
+        cv_.notify_all();
+    }
+
+    void _heavyFence() const
+    {
+        if (asymmetric_) {
+            // cannot fail once the process is registered
+            ::syscall(SYS_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0, 0);
+        }
+        else {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+    }
+
+private:
+    const std::size_t capacity_;
+    const std::size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+    const bool asymmetric_; // membarrier() usable, see _wake
+
+    // written by the consumer
+    alignas(kCacheLineSize) std::atomic<std::size_t> head_{0};
+    std::size_t cachedTail_{0};
+
+    // written by the producer
+    alignas(kCacheLineSize) std::atomic<std::size_t> tail_{0};
+    std::size_t cachedHead_{0};
+    std::size_t writeTail_{0}; // tail_ plus staged elements
+
+    // slow path, shared by both sides
+    alignas(kCacheLineSize) std::atomic<bool> closed_{false};
+    std::atomic<bool> producerParked_{false};
+    std::atomic<bool> consumerParked_{false};
+    std::mutex mutex_;
+    std::condition_variable cv_;
+};
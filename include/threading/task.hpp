@@ -0,0 +1,461 @@
+// include/threading/task.hpp
+#pragma once
+#include "event_fd.hpp"
+#include "network/contracts/reactor.hpp"
+#include "thread_safe_queue.hpp"
+#include "timer_wheel.hpp"
+#include "worker_pool.hpp"
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <semaphore>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+/*
+Coroutine task type for sequential-looking asynchronous code.
+
+A Task<T> is lazy: calling the coroutine only allocates its frame, the
+body starts when the task is awaited (or handed to spawn() / syncWait()).
+When it finishes, it resumes its awaiter directly (symmetric transfer: no
+queueing, and in optimized builds no stack growth across long await
+chains). A suspended task holds no thread, so thousands can wait on
+sockets and timers at once.
+
+    Task<Reply> fetch(WorkerPool& pool, IoScheduler& io, int fd)
+    {
+        co_await writable(io, fd);
+        sendRequest(fd);
+        co_await readable(io, fd);          // resumes on the reactor thread
+        co_await schedule(pool);            // hop onto a worker
+        co_return parseReply(fd);
+    }
+
+    Task<> poll(WorkerPool& pool, IoScheduler& io, TimerWheel& timers)
+    {
+        for (;;) {
+            process(co_await fetch(pool, io, connect()));
+            co_await sleepFor(timers, 5s);
+        }
+    }
+
+    IoScheduler io(reactor);                // on the reactor thread
+    spawn(pool, poll(pool, io, timers));
+    Reply r = syncWait(fetch(pool, io, fd));    // blocking
+
+Awaitables resume the coroutine on whichever thread signals it:
+schedule(pool) on a pool worker, readable()/writable() on the thread
+running the reactor's poll(), sleepFor() wherever the TimerWheel
+dispatches (inside advance(), or on its pool). Any of them may be awaited
+from any thread. Exceptions propagate to the awaiter like in ordinary
+calls; a spawned task that throws terminates the program, like a
+std::thread would.
+*/
+template <typename T = void> class Task;
+
+namespace task_detail
+{
+
+// resumes whoever awaited the finished task
+struct FinalAwaiter
+{
+    bool await_ready() const noexcept { return false; }
+
+    template <typename P>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<P> h) noexcept
+    {
+        auto continuation = h.promise().continuation;
+        if (continuation) {
+            return continuation;
+        }
+        return std::noop_coroutine();
+    }
+
+    void await_resume() const noexcept {}
+};
+
+struct PromiseBase
+{
+    std::coroutine_handle<> continuation;
+    std::exception_ptr error;
+
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    FinalAwaiter final_suspend() const noexcept { return {}; }
+    void unhandled_exception() { error = std::current_exception(); }
+};
+
+template <typename T> struct Promise : PromiseBase
+{
+    std::optional<T> value;
+
+    Task<T> get_return_object();
+
+    template <typename U> void return_value(U&& v)
+    {
+        value.emplace(std::forward<U>(v));
+    }
+
+    T take()
+    {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+        return std::move(*value);
+    }
+};
+
+template <> struct Promise<void> : PromiseBase
+{
+    Task<void> get_return_object();
+
+    void return_void() {}
+
+    void take()
+    {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+};
+
+// fire-and-forget frame: starts right away, destroys itself at the end
+struct Detached
+{
+    struct promise_type
+    {
+        Detached get_return_object() { return {}; }
+        std::suspend_never initial_suspend() const noexcept { return {}; }
+        std::suspend_never final_suspend() const noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+
+// blocks syncWait() until the frame has fully suspended at its end, so
+// it can be destroyed right after
+struct Blocking
+{
+    struct promise_type
+    {
+        std::binary_semaphore* done = nullptr;
+
+        Blocking get_return_object()
+        {
+            return Blocking{
+                std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+
+        auto final_suspend() const noexcept
+        {
+            struct Signal
+            {
+                bool await_ready() const noexcept { return false; }
+                void await_suspend(
+                    std::coroutine_handle<promise_type> h) const noexcept
+                {
+                    h.promise().done->release();
+                }
+                void await_resume() const noexcept {}
+            };
+            return Signal{};
+        }
+
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+} // namespace task_detail
+
+template <typename T> class [[nodiscard]] Task
+{
+public:
+    using promise_type = task_detail::Promise<T>;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    Task() = default;
+    explicit Task(Handle h) : handle_(h) {}
+
+    Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+
+    Task& operator=(Task&& other) noexcept
+    {
+        if (this != &other) {
+            _destroy();
+            handle_ = std::exchange(other.handle_, {});
+        }
+        return *this;
+    }
+
+    ~Task() { _destroy(); }
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    bool valid() const { return static_cast<bool>(handle_); }
+    bool done() const { return handle_ && handle_.done(); }
+
+    // co_await task: runs it and resumes here with its result
+    auto operator co_await() && noexcept
+    {
+        struct Awaiter
+        {
+            Handle handle;
+
+            bool await_ready() const noexcept { return !handle; }
+
+            std::coroutine_handle<> await_suspend(
+                std::coroutine_handle<> awaiting) noexcept
+            {
+                handle.promise().continuation = awaiting;
+                return handle;
+            }
+
+            T await_resume()
+            {
+                if (!handle) {
+                    throw std::logic_error("awaiting an empty Task");
+                }
+                return handle.promise().take();
+            }
+        };
+        return Awaiter{handle_};
+    }
+
+private:
+    void _destroy()
+    {
+        if (handle_) {
+            handle_.destroy();
+            handle_ = {};
+        }
+    }
+
+    Handle handle_;
+};
+
+template <typename T> Task<T> task_detail::Promise<T>::get_return_object()
+{
+    return Task<T>{std::coroutine_handle<Promise<T>>::from_promise(*this)};
+}
+
+inline Task<void> task_detail::Promise<void>::get_return_object()
+{
+    return Task<void>{
+        std::coroutine_handle<Promise<void>>::from_promise(*this)};
+}
+
+// co_await schedule(pool): continue on one of the pool's workers
+inline auto schedule(WorkerPool& pool)
+{
+    struct Awaiter
+    {
+        WorkerPool& pool;
+
+        bool await_ready() const noexcept { return false; }
+
+        void await_suspend(std::coroutine_handle<> h)
+        {
+            pool.addJob([h]() {
+                h.resume();
+            });
+        }
+
+        void await_resume() const noexcept {}
+    };
+    return Awaiter{pool};
+}
+
+/*
+Hands fd registrations to the thread running the reactor's poll().
+
+IReactor implementations are not thread-safe (EpollReactor keeps its
+callbacks in a plain map), so a coroutine resumed on a pool worker must not
+call add() itself. readable() / writable() queue the registration here and
+signal an EventFd the reactor watches; the reactor thread adds the fd on its
+next wake-up and resumes the coroutine when the fd is ready.
+
+Construct and destroy it on the reactor thread (or while nobody polls). The
+reactor must outlive it, and it must outlive the coroutines awaiting on it.
+*/
+class IoScheduler
+{
+public:
+    explicit IoScheduler(IReactor& reactor) : reactor_(reactor)
+    {
+        pending_.set_on_push([this]() {
+            wake_.signal();
+        });
+        reactor_.add(wake_.fd(), IoEvent::Readable, [this](int, IoEvent) {
+            _registerPending();
+        });
+    }
+
+    ~IoScheduler()
+    {
+        try {
+            reactor_.remove(wake_.fd());
+        }
+        catch (...) {
+            // the reactor may have been closed already: nothing to undo
+        }
+    }
+
+    IoScheduler(const IoScheduler&) = delete;
+    IoScheduler& operator=(const IoScheduler&) = delete;
+
+    // what an awaiter leaves behind for the reactor thread
+    struct Registration
+    {
+        int fd;
+        IoEvent events;
+        std::coroutine_handle<> handle;
+        IoEvent* received;          // set before the handle is resumed
+        std::exception_ptr* error;  // set instead when add() fails
+    };
+
+    // safe from any thread
+    void submit(Registration r) { pending_.push_back(r); }
+
+private:
+    void _registerPending()
+    {
+        wake_.drain();
+        while (auto next = pending_.try_pop_front()) {
+            const Registration r = *next;
+            try {
+                reactor_.add(r.fd, r.events, [this, r](int fd, IoEvent got) {
+                    *r.received = got;
+                    // IReactor keeps this callback alive until it returns
+                    reactor_.remove(fd);
+                    r.handle.resume();
+                });
+                continue;
+            }
+            catch (...) {
+                *r.error = std::current_exception();
+            }
+            r.handle.resume(); // rethrows at the co_await
+        }
+    }
+
+    IReactor& reactor_;
+    EventFd wake_;
+    ThreadSafeQueue<Registration> pending_;
+};
+
+/*
+co_await readable(io, fd) / writable(io, fd): suspend until the fd is
+ready, registering it with the reactor for that one wake-up. The result
+carries the events reported, Error and Closed included. The fd must not be
+registered with the reactor already; if the reactor refuses it, the error
+is rethrown at the co_await.
+*/
+inline auto awaitIo(IoScheduler& io, int fd, IoEvent events)
+{
+    struct Awaiter
+    {
+        IoScheduler& io;
+        int fd;
+        IoEvent events;
+        IoEvent received{};
+        std::exception_ptr error{};
+
+        bool await_ready() const noexcept { return false; }
+
+        void await_suspend(std::coroutine_handle<> h)
+        {
+            io.submit(
+                IoScheduler::Registration{fd, events, h, &received, &error});
+        }
+
+        IoEvent await_resume() const
+        {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+            return received;
+        }
+    };
+    return Awaiter{io, fd, events};
+}
+
+inline auto readable(IoScheduler& io, int fd)
+{
+    return awaitIo(io, fd, IoEvent::Readable);
+}
+
+inline auto writable(IoScheduler& io, int fd)
+{
+    return awaitIo(io, fd, IoEvent::Writable);
+}
+
+// co_await sleepFor(timers, 50ms): resumes where the wheel dispatches
+inline auto sleepFor(TimerWheel& timers, TimerWheel::Clock::duration delay)
+{
+    struct Awaiter
+    {
+        TimerWheel& timers;
+        TimerWheel::Clock::duration delay;
+
+        bool await_ready() const noexcept { return false; }
+
+        void await_suspend(std::coroutine_handle<> h)
+        {
+            timers.schedule(delay, [h]() {
+                h.resume();
+            });
+        }
+
+        void await_resume() const noexcept {}
+    };
+    return Awaiter{timers, delay};
+}
+
+// run the task on the calling thread up to its first suspension, then
+// let it finish on its own (e.g. from inside the reactor loop)
+inline void spawn(Task<void> task)
+{
+    [](Task<void> t) -> task_detail::Detached {
+        co_await std::move(t);
+    }(std::move(task));
+}
+
+// start the task on the pool and let it run to completion on its own
+inline void spawn(WorkerPool& pool, Task<void> task)
+{
+    [](WorkerPool& p, Task<void> t) -> task_detail::Detached {
+        co_await schedule(p);
+        co_await std::move(t);
+    }(pool, std::move(task));
+}
+
+// run the task to completion, blocking the calling thread until it is done
+template <typename T> T syncWait(Task<T> task)
+{
+    std::binary_semaphore done{0};
+    task_detail::Promise<T> result; // only its value and error are used
+    auto runner = [](Task<T>& t,
+                     task_detail::Promise<T>& r) -> task_detail::Blocking {
+        try {
+            if constexpr (std::is_void_v<T>) {
+                co_await std::move(t);
+            }
+            else {
+                r.value.emplace(co_await std::move(t));
+            }
+        }
+        catch (...) {
+            r.error = std::current_exception();
+        }
+    }(task, result);
+    runner.handle.promise().done = &done;
+    runner.handle.resume();
+    done.acquire();
+    runner.handle.destroy();
+    return result.take();
+}
@@ -0,0 +1,102 @@
+// include/threading/task_graph.hpp
+#pragma once
+#include "job.hpp"
+#include "worker_pool.hpp"
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <initializer_list>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/*
+Dependency graph of tasks executed on a WorkerPool.
+
+Tasks declare their predecessors; run() hands every task with no
+predecessor to the pool, and each finishing task decrements the counters of
+its successors, releasing those that reach zero. Independent branches
+overlap instead of being serialized behind barriers:
+
+    decode --> simulate --> serialize --> send
+          \--> audio ------------------/
+
+    TaskGraph frame;
+    auto decode = frame.add(decodeInput);
+    auto sim = frame.add(simulate, {decode});
+    auto audio = frame.add(mixAudio, {decode});
+    auto ser = frame.add(serialize, {sim});
+    frame.add(send, {ser, audio});
+    while (running) {
+        frame.run(pool);        // same nodes every frame, no allocation
+    }
+
+Nodes are built once and reused: run() only resets the counters. A
+finishing task runs one released successor itself (keeping a chain on the
+same worker) and pushes the others as jobs. The calling thread helps with
+queued jobs until the graph completes. If a task throws, the tasks that
+depend on it are skipped and the first exception is rethrown by run(). A
+task the pool refuses (stopped pool) is skipped the same way, with the
+pool's error.
+*/
+class TaskGraph
+{
+public:
+    using TaskId = size_t;
+
+    TaskGraph() = default;
+    TaskGraph(const TaskGraph&) = delete;
+    TaskGraph& operator=(const TaskGraph&) = delete;
+
+    // fn is called once per run(), so it must be callable repeatedly
+    template <typename F>
+        requires std::is_invocable_v<std::decay_t<F>&>
+    TaskId add(F&& fn, std::initializer_list<TaskId> after = {})
+    {
+        const TaskId id = nodes_.size();
+        nodes_.emplace_back(Job(std::forward<F>(fn)));
+        for (TaskId before : after) {
+            precede(before, id);
+        }
+        validated_ = false;
+        return id;
+    }
+
+    // `after` starts only once `before` has finished
+    void precede(TaskId before, TaskId after);
+
+    size_t size() const { return nodes_.size(); }
+
+    // executes every task once, respecting dependencies; blocks (helping
+    // the pool) until all tasks finished. Throws std::logic_error on a
+    // cycle or when the graph is already running.
+    void run(WorkerPool& pool);
+
+private:
+    struct Node
+    {
+        explicit Node(Job f) : fn(std::move(f)) {}
+
+        Job fn;
+        std::vector<TaskId> successors;
+        size_t predecessors{0};
+        std::atomic<size_t> remaining{0};
+        std::atomic<bool> skip{false}; // a predecessor failed
+    };
+
+    void _validate();
+    void _execute(TaskId id);
+    // hands the task to the pool; runs it as skipped if the pool refuses
+    void _submit(TaskId id);
+    void _fail();
+
+private:
+    std::deque<Node> nodes_; // stable addresses for the atomics
+    bool validated_{false};
+    WorkerPool* pool_{nullptr};
+    std::atomic<bool> running_{false};
+    std::atomic<size_t> outstanding_{0};
+    std::atomic<bool> failed_{false};
+    std::exception_ptr error_;
+};
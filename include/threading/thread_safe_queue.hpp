@@ -1,21 +1,53 @@
 #pragma once
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <cstddef>
 #include <deque>
+#include <functional>
+#include <iterator>
 #include <mutex>
 #include <optional>
+#include <ranges>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 /*
 Exception-safe thread-safe queue implementation using std::deque.
 If an exception is thrown during push operations, the queue remains unchanged.
 (strong exception safety)
+
+Elements are moved in and out whenever that cannot throw
+(std::move_if_noexcept), so large messages are not copied on their way
+through the queue.
+
+push_batch / pop_batch transfer many elements under one lock acquisition and
+one notify:
+
+    producer: q.push_batch(std::move(outgoing));   // outgoing is a range
+    consumer: while (q.pop_batch(inbox, 64) != 0) { ... inbox.clear(); }
+
+Consumers that cannot block (an event loop tick) use try_pop_front() or the
+timed pop_front_for / pop_front_until. To let an EpollReactor poll the queue,
+hook an EventFd (threading/event_fd.hpp):
+
+    EventFd ready;
+    results.set_on_push([&ready]() {
+        ready.signal();
+    });
+    reactor.add(ready.fd(), IoEvent::Readable, [&](int, IoEvent) {
+        ready.drain();
+        while (auto r = results.try_pop_front()) { ... }
+    });
 */
 template <typename TType> class ThreadSafeQueue
 {
 public:
     void push_back(const TType& newElement)
     {
+        bool wasEmpty = false;
         {
             std::lock_guard<std::mutex> lock(mutex_);
 
@@ -26,14 +58,37 @@ public:
             // TType's copy/move constructor may throw an exception.
             // but the std container guarantees that if an exception is thrown,
             // the container remains unchanged.
+            wasEmpty = queue_.empty();
             queue_.push_back(newElement);
         }
         // notify one waiting thread that an element has been added
-        cv_.notify_one();
+        _notifyPushed(wasEmpty, 1);
+    }
+
+    void push_back(TType&& newElement)
+    {
+        emplace_back(std::move(newElement));
+    }
+
+    template <typename... Args> void emplace_back(Args&&... args)
+    {
+        bool wasEmpty = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            if (closed_.load()) {
+                throw std::runtime_error(
+                    "Cannot push to a closed ThreadSafeQueue.");
+            }
+            wasEmpty = queue_.empty();
+            queue_.emplace_back(std::forward<Args>(args)...);
+        }
+        _notifyPushed(wasEmpty, 1);
     }
 
     void push_front(const TType& newElement)
     {
+        bool wasEmpty = false;
         {
             std::lock_guard<std::mutex> lock(mutex_);
 
@@ -41,12 +96,72 @@ public:
                 throw std::runtime_error(
                     "Cannot push to a closed ThreadSafeQueue.");
             }
+            wasEmpty = queue_.empty();
             queue_.push_front(newElement);
         }
         // notify one waiting thread that an element has been added
-        cv_.notify_one();
+        _notifyPushed(wasEmpty, 1);
     }
 
+    void push_front(TType&& newElement)
+    {
+        emplace_front(std::move(newElement));
+    }
+
+    template <typename... Args> void emplace_front(Args&&... args)
+    {
+        bool wasEmpty = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            if (closed_.load()) {
+                throw std::runtime_error(
+                    "Cannot push to a closed ThreadSafeQueue.");
+            }
+            wasEmpty = queue_.empty();
+            queue_.emplace_front(std::forward<Args>(args)...);
+        }
+        _notifyPushed(wasEmpty, 1);
+    }
+
+    // appends every element of items in order, moving them out of an rvalue
+    // range. All or nothing: if one element fails to copy, none are added.
+    template <std::ranges::input_range Range>
+        requires std::constructible_from<TType,
+                                         std::ranges::range_reference_t<Range>>
+    void push_batch(Range&& items)
+    {
+        bool wasEmpty = false;
+        std::size_t added = 0;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            if (closed_.load()) {
+                throw std::runtime_error(
+                    "Cannot push to a closed ThreadSafeQueue.");
+            }
+            wasEmpty = queue_.empty();
+            try {
+                for (auto&& item : items) {
+                    if constexpr (std::is_lvalue_reference_v<Range>) {
+                        queue_.push_back(item);
+                    }
+                    else {
+                        queue_.push_back(std::move(item));
+                    }
+                    ++added;
+                }
+            }
+            catch (...) {
+                // roll back what this batch added (moved-from sources of an
+                // rvalue range are not restored)
+                queue_.erase(queue_.end() - static_cast<std::ptrdiff_t>(added),
+                             queue_.end());
+                throw;
+            }
+        }
+        _notifyPushed(wasEmpty, added);
+    }
     std::optional<TType> pop_back_optional()
     {
         std::unique_lock<std::mutex> lock(mutex_);
@@ -58,7 +173,7 @@ public:
             // queue is closed and empty, return nullopt
             return std::nullopt;
         }
-        TType element = queue_.back();
+        TType element = std::move_if_noexcept(queue_.back());
         queue_.pop_back();
         return element;
     }
@@ -73,11 +188,35 @@ public:
             // queue is closed and empty, return nullopt
             return std::nullopt;
         }
-        TType element = queue_.front();
+        TType element = std::move_if_noexcept(queue_.front());
         queue_.pop_front();
         return element;
     }
 
+    // blocks until at least one element is available, then moves up to max
+    // elements from the front into out (appended). Returns how many were
+    // taken; 0 means the queue is closed and empty (or max is 0).
+    std::size_t pop_batch(std::vector<TType>& out, std::size_t max)
+    {
+        if (max == 0) {
+            return 0;
+        }
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this]() {
+            return !queue_.empty() || closed_.load();
+        });
+        const std::size_t n = std::min(max, queue_.size());
+        // reserve first so the appends below cannot reallocate and throw
+        out.reserve(out.size() + n);
+        for (std::size_t i = 0; i < n; ++i) {
+            out.push_back(std::move_if_noexcept(queue_.front()));
+            queue_.pop_front();
+        }
+        return n;
+    }
+
+    // pop_back / pop_front have no empty result: once the queue is closed
+    // and drained they throw std::runtime_error instead of blocking forever
     TType pop_back()
     {
         // when the exception is thrown, RAII will ensure the mutex is unlocked
@@ -89,11 +228,12 @@ public:
         // !!condition_variable wait() may throw std::system_error if the mutex
         // is not locked
         cv_.wait(lock, [this]() {
-            return !queue_.empty();
+            return !queue_.empty() || closed_.load();
         });
+        _throwIfDrained();
 
         // the copy/move constructor of TType may throw an exception here
-        TType element = queue_.back();
+        TType element = std::move_if_noexcept(queue_.back());
         queue_.pop_back();
         return element;
     }
@@ -103,9 +243,10 @@ public:
         std::unique_lock<std::mutex> lock(mutex_);
         // blocking current thread until queue is not empty and then lock mutex
         cv_.wait(lock, [this]() {
-            return !queue_.empty();
+            return !queue_.empty() || closed_.load();
         });
-        TType element = queue_.front();
+        _throwIfDrained();
+        TType element = std::move_if_noexcept(queue_.front());
         queue_.pop_front();
 
         // from C++11 it's guaranteed that return a named variable will use move
@@ -114,17 +255,99 @@ public:
         return element;
     }
 
+    // never blocks; nullopt when the queue is currently empty
+    std::optional<TType> try_pop_front()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (queue_.empty()) {
+            return std::nullopt;
+        }
+        return _takeFront();
+    }
+
+    // nullopt when nothing arrived in time, or the queue is closed and empty
+    template <typename Rep, typename Period>
+    std::optional<TType>
+    pop_front_for(const std::chrono::duration<Rep, Period>& timeout)
+    {
+        return pop_front_until(std::chrono::steady_clock::now() + timeout);
+    }
+
+    template <typename Clock, typename Duration>
+    std::optional<TType>
+    pop_front_until(const std::chrono::time_point<Clock, Duration>& deadline)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        const bool ready = cv_.wait_until(lock, deadline, [this]() {
+            return !queue_.empty() || closed_.load();
+        });
+        if (!ready || queue_.empty()) {
+            return std::nullopt;
+        }
+        return _takeFront();
+    }
+
     bool empty()
     {
         std::lock_guard<std::mutex> lock(mutex_);
         return queue_.empty();
     }
 
-    void close()
+    std::size_t size()
     {
         std::lock_guard<std::mutex> lock(mutex_);
-        closed_.store(true);
-        cv_.notify_all();
+        return queue_.size();
+    }
+
+    bool closed() const { return closed_.load(); }
+
+    void close()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            closed_.store(true);
+            cv_.notify_all();
+        }
+        if (onPush_) {
+            onPush_();
+        }
+    }
+
+    // Called (outside the lock) whenever a push makes the empty queue
+    // non-empty, and once on close(). Meant to signal an EventFd watched by
+    // a reactor; the consumer then drains with try_pop_front() until it
+    // returns nullopt. Set it before the queue is shared between threads.
+    void set_on_push(std::function<void()> hook) { onPush_ = std::move(hook); }
+
+private:
+    TType _takeFront()
+    {
+        TType element = std::move_if_noexcept(queue_.front());
+        queue_.pop_front();
+        return element;
+    }
+
+    void _throwIfDrained() const
+    {
+        if (queue_.empty()) {
+            throw std::runtime_error("ThreadSafeQueue is closed and empty.");
+        }
+    }
+
+    void _notifyPushed(bool wasEmpty, std::size_t added)
+    {
+        if (added == 0) {
+            return;
+        }
+        if (added == 1) {
+            cv_.notify_one();
+        }
+        else {
+            cv_.notify_all();
+        }
+        if (wasEmpty && onPush_) {
+            onPush_();
+        }
     }
 
 private:
@@ -132,4 +355,5 @@ private:
     std::mutex mutex_;
     std::atomic<bool> closed_{false};
     std::condition_variable cv_;
+    std::function<void()> onPush_;
 };
@@ -1,6 +1,20 @@
 // include/threading/threading.hpp
 #pragma once
 
+#include "cpu_topology.hpp"
+#include "event_fd.hpp"
+#include "future.hpp"
+#include "idle_strategy.hpp"
+#include "job.hpp"
+#include "mpmc_queue.hpp"
+#include "parallel.hpp"
+#include "pool_metrics.hpp"
+#include "spsc_queue.hpp"
+#include "task.hpp"
+#include "task_graph.hpp"
 #include "thread.hpp"
 #include "thread_safe_queue.hpp"
+#include "timer_fd.hpp"
+#include "timer_wheel.hpp"
+#include "work_stealing_deque.hpp"
 #include "worker_pool.hpp"
@@ -0,0 +1,86 @@
+// include/threading/timer_fd.hpp
+#pragma once
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+/*
+RAII wrapper around a non-blocking Linux timerfd on CLOCK_MONOTONIC (the
+clock behind std::chrono::steady_clock).
+
+Register fd() as readable with the reactor, arm it, and drain() in the
+callback. Expirations coalesce: drain() returns how many happened since the
+last read.
+*/
+class TimerFd
+{
+public:
+    TimerFd()
+    {
+        fd_ = ::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        if (fd_ == -1) {
+            throw std::runtime_error(std::string("timerfd_create failed: ")
+                                     + std::strerror(errno));
+        }
+    }
+
+    ~TimerFd() { ::close(fd_); }
+
+    TimerFd(const TimerFd&) = delete;
+    TimerFd& operator=(const TimerFd&) = delete;
+
+    int fd() const { return fd_; }
+
+    // one-shot at an absolute steady_clock time; times in the past fire
+    // right away
+    void armAt(std::chrono::steady_clock::time_point when)
+    {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      when.time_since_epoch())
+                      .count();
+        // an all-zero it_value would disarm instead
+        _set(ns > 0 ? ns : 1, 0, TFD_TIMER_ABSTIME);
+    }
+
+    // relative first expiry, then every interval (0: one-shot)
+    void arm(std::chrono::nanoseconds delay,
+             std::chrono::nanoseconds interval = {})
+    {
+        _set(delay.count() > 0 ? delay.count() : 1, interval.count(), 0);
+    }
+
+    void disarm() { _set(0, 0, 0); }
+
+    // expirations since the last drain (0 if none)
+    std::uint64_t drain()
+    {
+        std::uint64_t count = 0;
+        while (::read(fd_, &count, sizeof(count)) == -1) {
+            if (errno != EINTR) {
+                return 0; // EAGAIN: not expired yet
+            }
+        }
+        return count;
+    }
+
+private:
+    void _set(std::int64_t valueNs, std::int64_t intervalNs, int flags)
+    {
+        itimerspec spec{};
+        spec.it_value.tv_sec = valueNs / 1'000'000'000;
+        spec.it_value.tv_nsec = valueNs % 1'000'000'000;
+        spec.it_interval.tv_sec = intervalNs / 1'000'000'000;
+        spec.it_interval.tv_nsec = intervalNs % 1'000'000'000;
+        if (::timerfd_settime(fd_, flags, &spec, nullptr) == -1) {
+            throw std::runtime_error(std::string("timerfd_settime failed: ")
+                                     + std::strerror(errno));
+        }
+    }
+
+    int fd_{-1};
+};
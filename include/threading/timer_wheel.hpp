@@ -0,0 +1,142 @@
+// include/threading/timer_wheel.hpp
+#pragma once
+#include "network/contracts/reactor.hpp"
+#include "timer_fd.hpp"
+#include "worker_pool.hpp"
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+/*
+Hierarchical timing wheel for delayed and periodic callbacks.
+
+Time is cut into ticks (1 ms by default). Four wheels of 256 slots cover
+256, 256^2, 256^3 and 256^4 ticks; a timer goes into the coarsest wheel
+its distance needs and moves down one wheel each time the finer wheel
+below completes a turn (a cascade), until it expires from wheel 0:
+
+    wheel 3 [256 x 16.7M ticks] -> wheel 2 [256 x 65536 ticks]
+            -> wheel 1 [256 x 256 ticks] -> wheel 0 [256 x 1 tick] -> fire
+
+Slots are intrusive lists over one node pool, so schedule() and cancel()
+are O(1) and allocate nothing once the pool has grown to the peak number
+of timers. A TimerId carries a generation: cancelling a timer that already
+fired, or whose slot was reused, is a harmless no-op.
+
+Expired callbacks run inside advance(), or are handed to a WorkerPool when
+the wheel was built with one (and run inside advance() again once that pool
+is stopped). advance() can be called from any loop, or
+the wheel can drive itself from an EpollReactor through a timerfd armed
+for the next due tick (no wake-ups while no timer is due soon):
+
+    TimerWheel timers(pool);
+    timers.attach(reactor);
+    auto id = timers.schedule(30s, [&] { session.expire(); });
+    timers.scheduleEvery(5s, [&] { sendHeartbeat(); });
+    timers.cancel(id);
+    while (running) { reactor.poll(); }
+
+schedule()/cancel() are thread-safe; advance() runs on one thread at a
+time. Timers fire no earlier than requested and up to one tick late. A
+periodic timer is re-armed before its callback is dispatched, so with a
+pool a slow callback may overlap its next period.
+*/
+class TimerWheel
+{
+public:
+    using Clock = std::chrono::steady_clock;
+    using Callback = std::function<void()>;
+
+    struct TimerId
+    {
+        std::uint32_t index = 0;
+        std::uint32_t generation = 0; // 0 is never issued
+
+        bool valid() const { return generation != 0; }
+    };
+
+    static constexpr std::size_t kLevels = 4;
+    static constexpr std::size_t kSlotBits = 8;
+    static constexpr std::size_t kSlots = std::size_t{1} << kSlotBits;
+
+    // callbacks run inside advance()
+    explicit TimerWheel(
+        std::chrono::nanoseconds tick = std::chrono::milliseconds(1));
+    // callbacks are added to the pool as jobs
+    explicit TimerWheel(
+        WorkerPool& pool,
+        std::chrono::nanoseconds tick = std::chrono::milliseconds(1));
+    ~TimerWheel();
+
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    TimerId schedule(Clock::duration delay, Callback cb);
+    // first call after one period, then every period
+    TimerId scheduleEvery(Clock::duration period, Callback cb);
+    // false when the timer already fired, was cancelled or never existed
+    bool cancel(TimerId id);
+
+    // fires everything due at `now`; returns how many callbacks fired
+    size_t advance(Clock::time_point now = Clock::now());
+
+    // time until the next tick that may fire something (a lower bound
+    // for timers still in the coarse wheels); nullopt when no timer is set
+    std::optional<Clock::duration> nextTimeout() const;
+
+    size_t size() const;
+
+    // drive advance() from the reactor's loop via a timerfd; the reactor
+    // must outlive the attachment (detach() or the destructor)
+    void attach(IReactor& reactor);
+    void detach();
+
+private:
+    static constexpr std::uint32_t kNil = UINT32_MAX;
+
+    struct Node
+    {
+        Callback callback;
+        std::uint64_t expiry = 0; // absolute tick
+        std::uint64_t period = 0; // ticks, 0 for one-shot
+        std::uint32_t generation = 1;
+        std::uint32_t prev = kNil;
+        std::uint32_t next = kNil;
+        std::uint16_t slot = 0; // level * kSlots + index
+        bool armed = false;
+    };
+
+    TimerId _add(Clock::duration delay, Clock::duration period, Callback cb);
+    std::uint64_t _ticksUntil(Clock::time_point t) const;
+    void _link(std::uint32_t index);
+    void _unlink(std::uint32_t index);
+    void _release(std::uint32_t index);
+    void _cascade(std::size_t level);
+    void _step(std::vector<Callback>& due);
+    std::optional<std::uint64_t> _nextDueTick() const;
+    void _rearm();
+    void _dispatch(std::vector<Callback>& due);
+
+private:
+    std::chrono::nanoseconds tick_;
+    Clock::time_point start_;
+    WorkerPool* pool_{nullptr};
+
+    mutable std::mutex mutex_;
+    std::uint64_t current_{0}; // last tick processed
+    std::vector<Node> nodes_;
+    std::vector<std::uint32_t> free_;
+    std::array<std::array<std::uint32_t, kSlots>, kLevels> heads_;
+    size_t armed_{0};
+
+    // reactor attachment
+    IReactor* reactor_{nullptr};
+    std::unique_ptr<TimerFd> timerFd_;
+    std::uint64_t armedTick_{UINT64_MAX}; // guarded by mutex_
+};
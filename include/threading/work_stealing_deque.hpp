@@ -0,0 +1,164 @@
+// include/threading/work_stealing_deque.hpp
+#pragma once
+#include "cache_line.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+/*
+Chase-Lev work-stealing deque (the C11 formulation of Le, Pop, Cohen and
+Zappa Nardelli, PPoPP'13).
+
+One owner thread pushes and pops at the bottom (LIFO, keeps its cache hot);
+any number of thieves steal from the top (FIFO, takes the oldest and usually
+largest piece of work):
+
+    top_ -> [ oldest | ... | newest ] <- bottom_
+             steal()          push() / pop()
+
+Only the last element is contended, and only then does the owner CAS. The
+ring grows when full; retired rings are kept until the deque is destroyed
+because a thief may still be reading from one.
+
+TType must be trivially copyable (the slots are atomics); WorkerPool stores
+job pointers.
+*/
+template <typename TType> class WorkStealingDeque
+{
+    static_assert(std::is_trivially_copyable_v<TType>,
+                  "WorkStealingDeque elements must be trivially copyable");
+
+public:
+    explicit WorkStealingDeque(std::size_t capacity = 256)
+    {
+        std::size_t cap = 1;
+        while (cap < capacity) {
+            cap <<= 1;
+        }
+        rings_.push_back(std::make_unique<Ring>(cap));
+        ring_.store(rings_.back().get(), std::memory_order_relaxed);
+    }
+
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+    // owner only
+    void push(TType element)
+    {
+        const std::int64_t b = bottom_.load(std::memory_order_relaxed);
+        const std::int64_t t = top_.load(std::memory_order_acquire);
+        Ring* ring = ring_.load(std::memory_order_relaxed);
+        if (b - t > static_cast<std::int64_t>(ring->capacity) - 1) {
+            ring = _grow(ring, t, b);
+        }
+        ring->put(b, element);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom_.store(b + 1, std::memory_order_relaxed);
+    }
+
+    // owner only; newest element first
+    std::optional<TType> pop()
+    {
+        const std::int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+        Ring* ring = ring_.load(std::memory_order_relaxed);
+        bottom_.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t t = top_.load(std::memory_order_relaxed);
+
+        if (t > b) {
+            // empty
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return std::nullopt;
+        }
+        TType element = ring->get(b);
+        if (t == b) {
+            // last element: race the thieves for it
+            const bool won = top_.compare_exchange_strong(
+                t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            if (!won) {
+                return std::nullopt;
+            }
+        }
+        return element;
+    }
+
+    // any thread; oldest element first. nullopt when empty or when another
+    // thread won the race for the element (callers simply try elsewhere)
+    std::optional<TType> steal()
+    {
+        std::int64_t t = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const std::int64_t b = bottom_.load(std::memory_order_acquire);
+        if (t >= b) {
+            return std::nullopt;
+        }
+        Ring* ring = ring_.load(std::memory_order_acquire);
+        TType element = ring->get(t);
+        if (!top_.compare_exchange_strong(t,
+                                          t + 1,
+                                          std::memory_order_seq_cst,
+                                          std::memory_order_relaxed)) {
+            return std::nullopt;
+        }
+        return element;
+    }
+
+    // snapshot only
+    std::size_t size_approx() const
+    {
+        const std::int64_t b = bottom_.load(std::memory_order_relaxed);
+        const std::int64_t t = top_.load(std::memory_order_relaxed);
+        return b > t ? static_cast<std::size_t>(b - t) : 0;
+    }
+
+    bool empty() const { return size_approx() == 0; }
+
+private:
+    struct Ring
+    {
+        explicit Ring(std::size_t cap) :
+            capacity(cap), mask(cap - 1), slots(new std::atomic<TType>[cap])
+        {
+        }
+
+        TType get(std::int64_t i) const
+        {
+            return slots[static_cast<std::size_t>(i) & mask].load(
+                std::memory_order_relaxed);
+        }
+
+        void put(std::int64_t i, TType v)
+        {
+            slots[static_cast<std::size_t>(i) & mask].store(
+                v, std::memory_order_relaxed);
+        }
+
+        std::size_t capacity;
+        std::size_t mask;
+        std::unique_ptr<std::atomic<TType>[]> slots;
+    };
+
+    Ring* _grow(Ring* old, std::int64_t t, std::int64_t b)
+    {
+        auto bigger = std::make_unique<Ring>(old->capacity * 2);
+        for (std::int64_t i = t; i < b; ++i) {
+            bigger->put(i, old->get(i));
+        }
+        Ring* ring = bigger.get();
+        rings_.push_back(std::move(bigger));
+        ring_.store(ring, std::memory_order_release);
+        return ring;
+    }
+
+private:
+    alignas(kCacheLineSize) std::atomic<std::int64_t> top_{0};
+    alignas(kCacheLineSize) std::atomic<std::int64_t> bottom_{0};
+    std::atomic<Ring*> ring_{nullptr};
+    // owner only; every ring ever used, freed with the deque
+    std::vector<std::unique_ptr<Ring>> rings_;
+};
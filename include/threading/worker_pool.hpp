@@ -1,9 +1,25 @@
 // include/threading/worker_pool.hpp
 #pragma once
+#include "cpu_topology.hpp"
+#include "future.hpp"
+#include "idle_strategy.hpp"
+#include "job.hpp"
+#include "mpmc_queue.hpp"
+#include "pool_metrics.hpp"
 #include "thread.hpp"
 #include "thread_safe_queue.hpp"
+#include "work_stealing_deque.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
 #include <functional>
+#include <latch>
 #include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 /*
 main thread (manages job queue)
@@ -14,6 +30,76 @@ main thread (manages job queue)
     |-- ...
 
 worker threads continuously fetch jobs from the job queue and execute them.
+
+The job queue is an unbounded ThreadSafeQueue by default. With
+Options::queueCapacity > 0 it is a lock-free BlockingMPMCQueue of that size
+instead: producers and workers no longer serialize on one mutex, and addJob()
+blocks while the queue is full (back-pressure).
+
+Work stealing (Options::workStealing): every worker also owns a Chase-Lev
+deque. Jobs added from inside a job go to the calling worker's deque, the job
+queue above becomes the injector for jobs from other threads:
+
+    addJob() from outside ----> [ injector ]
+                                     |
+    worker i: own deque (LIFO) -> injector -> steal from others (FIFO)
+
+Workers that find nothing park on a shared event count; addJob() only pays
+for a wake-up when some worker is actually parked. With Options::idleSpin a
+worker first stays awake (pause, then yield) for up to that long, adapting
+to the observed gap between jobs (threading/idle_strategy.hpp), so bursts of
+jobs are picked up without any wake-up at the cost of some CPU.
+
+submit() wraps a callable and its arguments into a job and returns a
+Future for its result (or exception). waitIdle() blocks until every job
+submitted so far, including jobs they spawned, has finished, without
+stopping the pool:
+
+    auto a = pool.submit(parseHeader, buf);
+    auto b = pool.submit(parseBody, buf);
+    use(a.get(), b.get());
+    pool.waitIdle();
+
+Priority lanes: addJob(Priority, job) puts a job in the High, Normal or
+Background lane, addJob(deadline, job) in an earliest-deadline-first lane.
+Workers take jobs in this order:
+
+    High (FIFO) -> deadlines (EDF) -> Normal (own deque, injector, steal)
+                -> Background
+
+so a burst of bulk work never delays request handlers queued behind it.
+Strict priority could starve the lower lanes forever; instead every
+Options::starvationLimit-th pick of a thread searches the lanes bottom-up
+(Background, then Normal), which bounds how long a queued job can wait
+while higher lanes stay busy. queueCapacity bounds the Normal lane only.
+
+    pool.addJob(WorkerPool::Priority::Background, [] { compactSnapshots(); });
+    pool.addJob(WorkerPool::Clock::now() + 5ms, [&] { reply(request); });
+
+Placement (Options::placement): Spread or Pack pins worker i to one CPU of
+CpuTopology::spreadOrder() / packOrder() and names the OS threads
+"worker_<i>". Each worker allocates its own state (deque, node cache) on its
+own thread after pinning, so that memory is first touched on the worker's
+NUMA node; the constructor returns once every worker is set up.
+
+Elastic mode (Options::maxWorkers > workers): the pool starts with
+`workers` threads and grows up to maxWorkers when jobs wait longer than
+spawnLatency, either seen by a worker taking an old job or by a monitor
+thread noticing that every worker is busy while jobs stay queued. Workers
+beyond `workers` retire after idleTimeout without work. A job about to
+block (a synchronous call, a long lock) can say so:
+
+    pool.addJob([&] {
+        WorkerPool::BlockingScope blocking(pool); // spawns a stand-in if
+        auto reply = client.call(request);        // no worker is idle
+    });
+
+Options::metrics records how long each job waited and ran and how busy
+each worker is (threading/pool_metrics.hpp); metrics() aggregates them.
+
+Jobs are queued by value as Job (threading/job.hpp): typical lambdas are
+stored inline, so addJob() does not allocate. Deque entries are Job nodes
+recycled through a per-thread cache.
 */
 class WorkerPool
 {
@@ -25,10 +111,140 @@ public:
         virtual void execute() = 0;
     };
 
+    enum class Priority
+    {
+        High,
+        Normal,
+        Background,
+    };
+
+    using Clock = std::chrono::steady_clock;
+
+    enum class Placement
+    {
+        Unpinned, // the scheduler may migrate workers
+        Spread,   // across packages and physical cores first
+        Pack,     // fill cores and packages one after the other
+    };
+
+    struct Options
+    {
+        size_t workers = 8;
+        // 0 = unbounded ThreadSafeQueue, otherwise bounded lock-free ring
+        size_t queueCapacity = 0;
+        // per-worker deques for jobs spawned by jobs, idle workers steal
+        bool workStealing = false;
+        // every Nth pick searches the lanes lowest first; 0 = strict order
+        size_t starvationLimit = 32;
+        Placement placement = Placement::Unpinned;
+        // longest a worker spins/yields before parking; 0 parks right away
+        std::chrono::nanoseconds idleSpin{0};
+        // elastic mode when > workers: grow up to maxWorkers threads
+        size_t maxWorkers = 0;
+        // queue wait that makes an elastic pool spawn a worker
+        std::chrono::nanoseconds spawnLatency = std::chrono::milliseconds(1);
+        // extra workers retire after this long without work
+        std::chrono::nanoseconds idleTimeout = std::chrono::seconds(10);
+        // per-worker latency histograms and busy/idle time, see metrics()
+        bool metrics = false;
+    };
+
+    // marks the calling job as blocked for its lifetime; in an elastic pool
+    // a worker is spawned to stand in when none is idle. No effect outside
+    // the pool's own jobs.
+    class BlockingScope
+    {
+    public:
+        explicit BlockingScope(WorkerPool& pool);
+        ~BlockingScope();
+        BlockingScope(const BlockingScope&) = delete;
+        BlockingScope& operator=(const BlockingScope&) = delete;
+
+    private:
+        WorkerPool* pool_;
+    };
+
     WorkerPool(size_t numberOfWorkers = 8);
+    explicit WorkerPool(const Options& options);
     ~WorkerPool();
 
-    void addJob(const std::function<void()>& jobToExecute);
+    template <typename F>
+        requires std::is_invocable_v<std::decay_t<F>&>
+    void addJob(F&& jobToExecute)
+    {
+        _push(Job(std::forward<F>(jobToExecute)), Priority::Normal);
+    }
+
+    template <typename F>
+        requires std::is_invocable_v<std::decay_t<F>&>
+    void addJob(Priority priority, F&& jobToExecute)
+    {
+        _push(Job(std::forward<F>(jobToExecute)), priority);
+    }
+
+    // runs ahead of Normal jobs, earliest deadline first; a deadline only
+    // orders jobs, it does not cancel late ones
+    template <typename F>
+        requires std::is_invocable_v<std::decay_t<F>&>
+    void addJob(Clock::time_point deadline, F&& jobToExecute)
+    {
+        _pushDeadline(Job(std::forward<F>(jobToExecute)), deadline);
+    }
+
+    void addJob(std::unique_ptr<IJob> job);
+
+    // runs fn(args...) on the pool; arguments are decay-copied like
+    // std::thread does
+    template <typename F, typename... Args>
+        requires std::is_invocable_v<std::decay_t<F>&, std::decay_t<Args>&...>
+    auto submit(F&& fn, Args&&... args)
+        -> Future<std::invoke_result_t<std::decay_t<F>&,
+                                       std::decay_t<Args>&...>>
+    {
+        using Result =
+            std::invoke_result_t<std::decay_t<F>&, std::decay_t<Args>&...>;
+        auto state = std::make_shared<FutureState<Result>>();
+        addJob([state,
+                fn = std::forward<F>(fn),
+                ... args = std::forward<Args>(args)]() mutable {
+            state->run(fn, args...);
+        });
+        return Future<Result>(std::move(state));
+    }
+
+    template <typename F, typename... Args>
+        requires std::is_invocable_v<std::decay_t<F>&, std::decay_t<Args>&...>
+    auto submit(Priority priority, F&& fn, Args&&... args)
+        -> Future<std::invoke_result_t<std::decay_t<F>&,
+                                       std::decay_t<Args>&...>>
+    {
+        using Result =
+            std::invoke_result_t<std::decay_t<F>&, std::decay_t<Args>&...>;
+        auto state = std::make_shared<FutureState<Result>>();
+        addJob(priority,
+               [state,
+                fn = std::forward<F>(fn),
+                ... args = std::forward<Args>(args)]() mutable {
+                   state->run(fn, args...);
+               });
+        return Future<Result>(std::move(state));
+    }
+
+    // block until all queued and running jobs are done; the pool keeps
+    // running. Must not be called from one of this pool's jobs.
+    void waitIdle();
+
+    // Runs one queued job on the calling thread, if there is one. Lets a
+    // thread waiting for its own jobs (parallel_for, task graphs) help
+    // instead of blocking. Returns false when no job was found.
+    bool runOneJob();
+
+    // queue depth and pending jobs; histograms and per-worker times stay
+    // empty unless Options::metrics is set
+    PoolMetrics metrics() const;
+
+    // worker threads currently running (changes in elastic mode)
+    size_t workerCount() const { return liveWorkers_.load(); }
 
     // wait for all worker threads to finish
     void joinAllWorkers();
@@ -37,8 +253,96 @@ public:
     void stop();
 
 private:
-    size_t numberOfWorkers_;
+    struct Worker
+    {
+        WorkStealingDeque<Job*> deque;
+        std::uint64_t rng;
+    };
+
+    // High and Background lanes; size is checked before taking the lock
+    struct Lane
+    {
+        ThreadSafeQueue<Job> queue;
+        std::atomic<size_t> size{0}; // queued jobs plus pushes in flight
+    };
+
+    struct DeadlineJob
+    {
+        Clock::time_point deadline;
+        std::uint64_t seq; // FIFO among equal deadlines
+        Job job;
+    };
+
+    void _run(size_t index, bool initial);
+    Job _waitForJob(size_t index, Worker* self, IdleStrategy& idle);
+    void _execute(Job& job);
+    bool _elastic() const { return maxWorkers_ > numberOfWorkers_; }
+    void _startWorker(size_t index, bool initial);
+    bool _spawnWorker(bool throttled);
+    bool _tryRetire(size_t index);
+    void _monitor();
+    void _push(Job job, Priority priority);
+    void _pushDeadline(Job job, Clock::time_point deadline);
+    void _enqueue(Job job, Priority priority);
+    Job _findJob(Worker* self);
+    Job _findNormal(Worker* self);
+    Job _popLane(Lane& lane);
+    Job _popDeadline();
+    static bool _runsAfter(const DeadlineJob& a, const DeadlineJob& b);
+    Job _popInjector();
+    Job _steal(Worker* self, std::uint64_t& rng);
+    bool _hasVisibleWork() const;
+    void _notifyWork();
+    bool _park(std::chrono::nanoseconds timeout = {});
+    void _finished();
+    Worker* _currentWorker() const;
+
+private:
+    size_t numberOfWorkers_; // the minimum in elastic mode
+    size_t maxWorkers_;
     //
-    ThreadSafeQueue<std::shared_ptr<IJob>> jobQueue_;
-    std::vector<std::unique_ptr<Thread>> workers_;
+    mutable ThreadSafeQueue<Job> jobQueue_;
+    std::unique_ptr<BlockingMPMCQueue<Job>> boundedQueue_;
+    std::vector<std::unique_ptr<Worker>> locals_; // work-stealing mode only
+    std::vector<std::unique_ptr<Thread>> workers_; // maxWorkers_ slots
+
+    Lane highLane_;
+    Lane backgroundLane_;
+    std::mutex deadlineMutex_;
+    std::vector<DeadlineJob> deadlineHeap_; // guarded by deadlineMutex_
+    std::uint64_t deadlineSeq_{0};          // guarded by deadlineMutex_
+    bool deadlineClosed_{false};            // guarded by deadlineMutex_
+    std::atomic<size_t> deadlineSize_{0};
+    size_t starvationLimit_;
+    std::chrono::nanoseconds idleSpin_;
+    std::latch workersReady_; // every worker has set up its state
+    std::vector<int> cpus_;   // placement plan, empty when unpinned
+
+    // elastic mode
+    std::chrono::nanoseconds spawnLatency_;
+    std::chrono::nanoseconds idleTimeout_;
+    mutable std::mutex elasticMutex_;
+    std::vector<bool> slotUsed_; // guarded by elasticMutex_
+    bool elasticClosed_{false};  // guarded by elasticMutex_
+    std::atomic<size_t> liveWorkers_{0};
+    std::atomic<size_t> blocked_{0}; // workers inside a BlockingScope
+    std::atomic<Clock::rep> lastSpawn_{0};
+    std::condition_variable monitorCv_; // waits on parkMutex_
+    std::unique_ptr<Thread> monitor_;
+
+    bool stampJobs_; // enqueue time needed (elastic or metrics)
+    // one block per worker slot plus one shared by helping threads; null
+    // unless Options::metrics
+    std::unique_ptr<WorkerStats[]> stats_;
+
+    // event count idle workers park on
+    std::mutex parkMutex_;
+    std::condition_variable parkCv_;
+    std::atomic<int> sleepers_{0};
+    std::uint64_t wakeEpoch_{0}; // guarded by parkMutex_
+    std::atomic<bool> stopping_{false};
+
+    // jobs pushed but not finished yet, for waitIdle()
+    std::atomic<size_t> pending_{0};
+    std::atomic<int> idleWaiters_{0};
 };
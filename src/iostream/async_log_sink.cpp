@@ -0,0 +1,151 @@
+#include "iostream/async_log_sink.hpp"
+#include <bit>
+#include <cerrno>
+#include <sys/uio.h>
+#include <utility>
+#include <vector>
+
+AsyncLogSink::AsyncLogSink(int fd, size_t capacity) :
+    fd_(fd), mask_(std::bit_ceil(capacity < 2 ? size_t{2} : capacity) - 1),
+    slots_(std::make_unique<Slot[]>(mask_ + 1))
+{
+    for (size_t i = 0; i <= mask_; ++i) {
+        slots_[i].seq.store(i, std::memory_order_relaxed);
+    }
+    writer_ = std::thread([this]() {
+        _run();
+    });
+}
+
+AsyncLogSink::~AsyncLogSink()
+{
+    stop_.store(true);
+    wake_.fetch_add(1);
+    wake_.notify_one();
+    writer_.join();
+}
+
+void AsyncLogSink::push(std::string_view record)
+{
+    std::uint64_t pos = tail_.load(std::memory_order_relaxed);
+    Slot* slot;
+    for (;;) {
+        slot = &slots_[pos & mask_];
+        const std::uint64_t seq = slot->seq.load(std::memory_order_acquire);
+        const auto diff =
+            static_cast<std::int64_t>(seq) - static_cast<std::int64_t>(pos);
+        if (diff == 0) {
+            if (tail_.compare_exchange_weak(
+                    pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        else if (diff < 0) {
+            // full: the writer has not freed this slot yet
+            std::this_thread::yield();
+            pos = tail_.load(std::memory_order_relaxed);
+        }
+        else {
+            pos = tail_.load(std::memory_order_relaxed);
+        }
+    }
+    slot->text.assign(record);
+    // seq_cst pairs with the writer's sleeping_ store: either it sees this
+    // record before parking or we see it parked
+    slot->seq.store(pos + 1);
+    if (sleeping_.load()) {
+        wake_.fetch_add(1);
+        wake_.notify_one();
+    }
+}
+
+void AsyncLogSink::drain()
+{
+    const std::uint64_t target = tail_.load();
+    std::uint64_t done = written_.load(std::memory_order_acquire);
+    while (done < target) {
+        if (sleeping_.load()) {
+            wake_.fetch_add(1);
+            wake_.notify_one();
+        }
+        written_.wait(done, std::memory_order_acquire);
+        done = written_.load(std::memory_order_acquire);
+    }
+}
+
+void AsyncLogSink::_run()
+{
+    std::vector<std::string> batch(kMaxBatch);
+    for (;;) {
+        const size_t count = _take(batch.data());
+        if (count > 0) {
+            _write(batch.data(), count);
+            for (size_t i = 0; i < count; ++i) {
+                batch[i].clear(); // keeps the capacity for the next swap
+            }
+            written_.fetch_add(count, std::memory_order_release);
+            batches_.fetch_add(1, std::memory_order_relaxed);
+            written_.notify_all();
+            continue;
+        }
+        if (stop_.load()) {
+            return; // stop_ is set after the last push: the ring is empty
+        }
+        const std::uint32_t seen = wake_.load();
+        sleeping_.store(true);
+        if (slots_[head_ & mask_].seq.load() != head_ + 1 && !stop_.load()) {
+            wake_.wait(seen);
+        }
+        sleeping_.store(false);
+    }
+}
+
+size_t AsyncLogSink::_take(std::string* batch)
+{
+    size_t count = 0;
+    while (count < kMaxBatch) {
+        Slot& slot = slots_[head_ & mask_];
+        if (slot.seq.load(std::memory_order_acquire) != head_ + 1) {
+            break;
+        }
+        // swap, so the slot gets back an emptied buffer with capacity
+        std::swap(batch[count++], slot.text);
+        slot.seq.store(head_ + mask_ + 1, std::memory_order_release);
+        ++head_;
+    }
+    return count;
+}
+
+void AsyncLogSink::_write(const std::string* batch, size_t count)
+{
+    iovec iov[kMaxBatch];
+    int n = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (!batch[i].empty()) {
+            iov[n].iov_base = const_cast<char*>(batch[i].data());
+            iov[n].iov_len = batch[i].size();
+            ++n;
+        }
+    }
+    iovec* next = iov;
+    while (n > 0) {
+        const ssize_t w = ::writev(fd_, next, n);
+        if (w < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return; // nowhere to report it; the records are lost
+        }
+        // partial write: skip what went out and retry the rest
+        auto left = static_cast<size_t>(w);
+        while (n > 0 && left >= next->iov_len) {
+            left -= next->iov_len;
+            ++next;
+            --n;
+        }
+        if (n > 0) {
+            next->iov_base = static_cast<char*>(next->iov_base) + left;
+            next->iov_len -= left;
+        }
+    }
+}
@@ -1,4 +1,42 @@
 #include "iostream/thread_safe_iostream.hpp"
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+
+namespace
+{
+
+std::unique_ptr<AsyncLogSink> g_async_owner;
+std::atomic<AsyncLogSink*> g_async_sink{nullptr};
+
+} // namespace
+
+void ThreadSafeIOStream::enableAsync(int fd, size_t capacity)
+{
+    if (g_async_sink.load() != nullptr) {
+        throw std::logic_error("ThreadSafeIOStream async mode already on");
+    }
+    {
+        // what was already written through std::cout goes out first
+        std::lock_guard<std::mutex> lock(g_cout_mutex);
+        std::cout.flush();
+    }
+    g_async_owner = std::make_unique<AsyncLogSink>(fd, capacity);
+    g_async_sink.store(g_async_owner.get(), std::memory_order_release);
+}
+
+void ThreadSafeIOStream::disableAsync()
+{
+    if (g_async_sink.exchange(nullptr) == nullptr) {
+        return;
+    }
+    g_async_owner.reset(); // writes what is left, joins the writer
+}
+
+bool ThreadSafeIOStream::isAsync()
+{
+    return g_async_sink.load(std::memory_order_acquire) != nullptr;
+}
 
 void ThreadSafeIOStream::setPrefix(const std::string& prefix)
 {
@@ -7,16 +45,19 @@ void ThreadSafeIOStream::setPrefix(const std::string& prefix)
 
 void ThreadSafeIOStream::flush()
 {
-    std::lock_guard<std::mutex> lock(g_cout_mutex);
-
     _flushCompletedLines();
     // Flush any remaining partial line
-    std::string remaining = buffer_.str();
+    const std::string_view remaining = buffer_.view();
     if (!remaining.empty()) {
-        std::cout << prefix_ << remaining;
+        record_.assign(prefix_);
+        record_.append(remaining);
+        _write(record_);
         buffer_.str(""); // Clear the buffer
         buffer_.clear(); // Clear any error flags
     }
+    if (AsyncLogSink* sink = g_async_sink.load(std::memory_order_acquire)) {
+        sink->drain();
+    }
 }
 
 // Handle manipulators like std::endl, std::flush, ends, etc.
@@ -38,18 +79,52 @@ ThreadSafeIOStream::operator<<(std::ios& (*manip)(std::ios&))
 
 void ThreadSafeIOStream::_flushCompletedLines()
 {
-    std::string content = buffer_.str();
-    size_t pos = 0;
+    // view() reads the buffer in place: an insertion that completes no
+    // line copies nothing
+    const std::string_view content = buffer_.view();
+    const size_t last = content.rfind('\n');
+    if (last == std::string_view::npos) {
+        return;
+    }
 
-    while ((pos = content.find('\n')) != std::string::npos) {
-        std::string line = content.substr(0, pos);
-        {
-            std::lock_guard<std::mutex> lock(g_cout_mutex);
-            std::cout << prefix_ << line << std::endl;
-        }
-        content.erase(0, pos + 1);
+    // all completed lines go out as one record, in one write
+    record_.clear();
+    size_t begin = 0;
+    while (begin <= last) {
+        const size_t end = content.find('\n', begin);
+        record_.append(prefix_);
+        record_.append(content.substr(begin, end - begin + 1));
+        begin = end + 1;
     }
-    buffer_.str(content);
+    _write(record_);
+
+    // keep the partial line, moving the storage out and back in
+    std::string rest = std::move(buffer_).str();
+    rest.erase(0, last + 1);
+    buffer_.str(std::move(rest));
     buffer_.clear();                 // Clear any error flags
     buffer_.seekp(0, std::ios::end); // Move the put pointer to the end
 }
+
+void ThreadSafeIOStream::_printQuestion(const std::string& question)
+{
+    record_.assign(prefix_);
+    record_.append(question);
+    record_.push_back('\n');
+    _write(record_);
+    // the question must be visible before we block on the answer
+    if (AsyncLogSink* sink = g_async_sink.load(std::memory_order_acquire)) {
+        sink->drain();
+    }
+}
+
+void ThreadSafeIOStream::_write(std::string_view text)
+{
+    if (AsyncLogSink* sink = g_async_sink.load(std::memory_order_acquire)) {
+        sink->push(text);
+        return;
+    }
+    std::lock_guard<std::mutex> lock(g_cout_mutex);
+    std::cout.write(text.data(), static_cast<std::streamsize>(text.size()));
+    std::cout.flush(); // one flush per write, not per line
+}
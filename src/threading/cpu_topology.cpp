@@ -0,0 +1,121 @@
+#include "threading/cpu_topology.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <sched.h>
+#include <string>
+#include <tuple>
+#include <utility>
+
+namespace
+{
+
+int readInt(const std::filesystem::path& path, int fallback)
+{
+    std::ifstream in(path);
+    int value;
+    if (in >> value) {
+        return value;
+    }
+    return fallback;
+}
+
+// cpuN/nodeM is a symlink to the node the CPU belongs to
+int nodeOf(const std::filesystem::path& cpuDir)
+{
+    std::error_code ec;
+    for (const auto& entry :
+         std::filesystem::directory_iterator(cpuDir, ec)) {
+        const std::string name = entry.path().filename().string();
+        if (name.size() > 4 && name.compare(0, 4, "node") == 0) {
+            try {
+                return std::stoi(name.substr(4));
+            }
+            catch (const std::exception&) {
+                continue;
+            }
+        }
+    }
+    return 0;
+}
+
+} // namespace
+
+CpuTopology::CpuTopology(std::vector<Cpu> cpus) : cpus_(std::move(cpus))
+{
+    std::sort(cpus_.begin(), cpus_.end(), [](const Cpu& a, const Cpu& b) {
+        return a.id < b.id;
+    });
+}
+
+CpuTopology CpuTopology::detect()
+{
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+        return CpuTopology({Cpu{0, 0, 0, 0}});
+    }
+    const std::filesystem::path root = "/sys/devices/system/cpu";
+    std::vector<Cpu> cpus;
+    for (int id = 0; id < CPU_SETSIZE; ++id) {
+        if (!CPU_ISSET(id, &allowed)) {
+            continue;
+        }
+        const auto dir = root / ("cpu" + std::to_string(id));
+        cpus.push_back(Cpu{id,
+                           readInt(dir / "topology/core_id", id),
+                           readInt(dir / "topology/physical_package_id", 0),
+                           nodeOf(dir)});
+    }
+    return CpuTopology(std::move(cpus));
+}
+
+size_t CpuTopology::nodeCount() const
+{
+    std::vector<int> nodes;
+    for (const auto& cpu : cpus_) {
+        if (std::find(nodes.begin(), nodes.end(), cpu.node) == nodes.end()) {
+            nodes.push_back(cpu.node);
+        }
+    }
+    return nodes.size();
+}
+
+std::vector<int> CpuTopology::spreadOrder() const
+{
+    // per package: first hyper-thread of every core, then the second, ...
+    std::map<int, std::vector<std::tuple<int, int, int>>> byPackage;
+    std::map<std::pair<int, int>, int> siblingsSeen;
+    for (const auto& cpu : cpus_) {
+        const int rank = siblingsSeen[{cpu.package, cpu.core}]++;
+        byPackage[cpu.package].emplace_back(rank, cpu.core, cpu.id);
+    }
+    for (auto& [package, list] : byPackage) {
+        std::sort(list.begin(), list.end());
+    }
+    // then deal the packages out round-robin
+    std::vector<int> order;
+    for (size_t i = 0; order.size() < cpus_.size(); ++i) {
+        for (const auto& [package, list] : byPackage) {
+            if (i < list.size()) {
+                order.push_back(std::get<2>(list[i]));
+            }
+        }
+    }
+    return order;
+}
+
+std::vector<int> CpuTopology::packOrder() const
+{
+    std::vector<Cpu> sorted = cpus_;
+    std::stable_sort(
+        sorted.begin(), sorted.end(), [](const Cpu& a, const Cpu& b) {
+            return std::tie(a.package, a.core) < std::tie(b.package, b.core);
+        });
+    std::vector<int> order;
+    for (const auto& cpu : sorted) {
+        order.push_back(cpu.id);
+    }
+    return order;
+}
@@ -0,0 +1,158 @@
+#include "threading/task_graph.hpp"
+#include <stdexcept>
+#include <thread>
+
+void TaskGraph::precede(TaskId before, TaskId after)
+{
+    if (before >= nodes_.size() || after >= nodes_.size()) {
+        throw std::out_of_range("TaskGraph task id out of range");
+    }
+    if (before == after) {
+        throw std::logic_error("TaskGraph task cannot depend on itself");
+    }
+    nodes_[before].successors.push_back(after);
+    ++nodes_[after].predecessors;
+    validated_ = false;
+}
+
+void TaskGraph::run(WorkerPool& pool)
+{
+    if (running_.exchange(true)) {
+        throw std::logic_error("TaskGraph is already running");
+    }
+    try {
+        _validate();
+    }
+    catch (...) {
+        running_.store(false);
+        throw;
+    }
+    if (nodes_.empty()) {
+        running_.store(false);
+        return;
+    }
+
+    pool_ = &pool;
+    failed_.store(false);
+    error_ = nullptr;
+    for (auto& node : nodes_) {
+        node.remaining.store(node.predecessors, std::memory_order_relaxed);
+        node.skip.store(false, std::memory_order_relaxed);
+    }
+    outstanding_.store(nodes_.size(), std::memory_order_release);
+
+    for (TaskId id = 0; id < nodes_.size(); ++id) {
+        if (nodes_[id].predecessors == 0) {
+            _submit(id);
+        }
+    }
+    // help instead of blocking idle
+    while (outstanding_.load(std::memory_order_acquire) != 0) {
+        if (!pool.runOneJob()) {
+            std::this_thread::yield();
+        }
+    }
+    running_.store(false);
+    if (error_) {
+        std::rethrow_exception(error_);
+    }
+}
+
+void TaskGraph::_validate()
+{
+    if (validated_) {
+        return;
+    }
+    // Kahn's algorithm: every node must become ready at some point
+    std::vector<size_t> indegree(nodes_.size());
+    std::vector<TaskId> ready;
+    for (TaskId id = 0; id < nodes_.size(); ++id) {
+        indegree[id] = nodes_[id].predecessors;
+        if (indegree[id] == 0) {
+            ready.push_back(id);
+        }
+    }
+    size_t seen = 0;
+    while (!ready.empty()) {
+        TaskId id = ready.back();
+        ready.pop_back();
+        ++seen;
+        for (TaskId succ : nodes_[id].successors) {
+            if (--indegree[succ] == 0) {
+                ready.push_back(succ);
+            }
+        }
+    }
+    if (seen != nodes_.size()) {
+        throw std::logic_error("TaskGraph contains a cycle");
+    }
+    validated_ = true;
+}
+
+void TaskGraph::_execute(TaskId id)
+{
+    while (true) {
+        Node& node = nodes_[id];
+        if (!node.skip.load(std::memory_order_acquire)) {
+            try {
+                node.fn();
+            }
+            catch (...) {
+                _fail();
+                node.skip.store(true, std::memory_order_relaxed);
+            }
+        }
+        const bool skipDependents = node.skip.load(std::memory_order_relaxed);
+
+        // release successors; keep one to run here, push the rest
+        TaskId next = nodes_.size();
+        for (TaskId succ : node.successors) {
+            Node& s = nodes_[succ];
+            if (skipDependents) {
+                s.skip.store(true, std::memory_order_relaxed);
+            }
+            if (s.remaining.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+                continue;
+            }
+            if (next == nodes_.size()) {
+                next = succ;
+            }
+            else {
+                _submit(succ);
+            }
+        }
+        // last: once this drops to 0 run() may return and the graph may be
+        // destroyed, so no member is read after it unless next still holds
+        // the count up
+        const bool last = next == nodes_.size();
+        outstanding_.fetch_sub(1, std::memory_order_acq_rel);
+        if (last) {
+            return;
+        }
+        id = next;
+    }
+}
+
+void TaskGraph::_submit(TaskId id)
+{
+    try {
+        pool_->addJob([this, id]() {
+            _execute(id);
+        });
+        return;
+    }
+    catch (...) {
+        // refused (stopped pool): record it and release the task here as
+        // skipped, so it and its dependents are still counted down
+        _fail();
+        nodes_[id].skip.store(true, std::memory_order_relaxed);
+    }
+    _execute(id);
+}
+
+void TaskGraph::_fail()
+{
+    if (!failed_.exchange(true)) {
+        error_ = std::current_exception();
+    }
+}
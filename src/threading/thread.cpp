@@ -1,11 +1,29 @@
 #include "threading/thread.hpp"
 #include "iostream/thread_safe_iostream.hpp"
+#include <pthread.h>
+#include <sched.h>
+#include <stdexcept>
+#include <system_error>
 
 Thread::Thread(const std::string& name, std::function<void()> funcToExecute) :
-    name_(name), function_(funcToExecute)
+    Thread(name, std::move(funcToExecute), Options{})
 {
 }
 
+Thread::Thread(const std::string& name,
+               std::function<void()> funcToExecute,
+               Options options) :
+    name_(name), function_(funcToExecute), options_(std::move(options))
+{
+    for (int cpu : options_.cpus) {
+        if (cpu < 0 || cpu >= CPU_SETSIZE) {
+            throw std::invalid_argument("Thread '" + name_ + "': CPU "
+                                        + std::to_string(cpu)
+                                        + " is out of range.");
+        }
+    }
+}
+
 Thread::~Thread()
 {
     // For RAII safety, ensure the thread is joined before destruction
@@ -24,10 +42,35 @@ void Thread::start()
         // if the exception is thrown, it will call std::terminate
         ts_cout.setPrefix("[" + name_ + "] ");
 
+        // pin before running anything, so the function's allocations are
+        // first touched on the CPU's NUMA node
+        const int result = _applyOptions();
+        setup_.store(result);
+        setup_.notify_one();
+        if (result != 1) {
+            return;
+        }
+
         // the function should be noexcept, otherwise std::terminate is
         // called
         function_();
     });
+
+    if (options_.cpus.empty()) {
+        return;
+    }
+    // wait for the placement so a rejected CPU set is reported here
+    int result = 0;
+    while ((result = setup_.load()) == 0) {
+        setup_.wait(0);
+    }
+    if (result != 1) {
+        thread_.join();
+        throw std::system_error(-result,
+                                std::generic_category(),
+                                "Thread '" + name_
+                                    + "' could not set its CPU affinity");
+    }
 }
 
 void Thread::stop()
@@ -36,3 +79,24 @@ void Thread::stop()
         thread_.join();
     }
 }
+
+int Thread::_applyOptions()
+{
+    if (options_.osName) {
+        // the kernel limits names to 15 characters; naming is best effort
+        pthread_setname_np(pthread_self(), name_.substr(0, 15).c_str());
+    }
+    if (!options_.cpus.empty()) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu : options_.cpus) {
+            CPU_SET(cpu, &set);
+        }
+        const int err =
+            pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        if (err != 0) {
+            return -err;
+        }
+    }
+    return 1;
+}
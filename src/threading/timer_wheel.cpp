@@ -0,0 +1,348 @@
+#include "threading/timer_wheel.hpp"
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+#include <utility>
+
+namespace
+{
+
+constexpr std::uint64_t kMaxDelta =
+    (std::uint64_t{1} << (TimerWheel::kSlotBits * TimerWheel::kLevels)) - 1;
+
+} // namespace
+
+TimerWheel::TimerWheel(std::chrono::nanoseconds tick) :
+    tick_(tick), start_(Clock::now())
+{
+    if (tick_.count() <= 0) {
+        throw std::invalid_argument("TimerWheel tick must be positive");
+    }
+    for (auto& level : heads_) {
+        level.fill(kNil);
+    }
+}
+
+TimerWheel::TimerWheel(WorkerPool& pool, std::chrono::nanoseconds tick) :
+    TimerWheel(tick)
+{
+    pool_ = &pool;
+}
+
+TimerWheel::~TimerWheel()
+{
+    detach();
+}
+
+TimerWheel::TimerId TimerWheel::schedule(Clock::duration delay, Callback cb)
+{
+    return _add(delay, Clock::duration::zero(), std::move(cb));
+}
+
+TimerWheel::TimerId TimerWheel::scheduleEvery(Clock::duration period,
+                                              Callback cb)
+{
+    if (period <= Clock::duration::zero()) {
+        throw std::invalid_argument("TimerWheel period must be positive");
+    }
+    return _add(period, period, std::move(cb));
+}
+
+bool TimerWheel::cancel(TimerId id)
+{
+    Callback dropped; // destroyed outside the lock
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (id.index >= nodes_.size()) {
+        return false;
+    }
+    Node& node = nodes_[id.index];
+    if (!node.armed || node.generation != id.generation) {
+        return false;
+    }
+    _unlink(id.index);
+    dropped = std::move(node.callback);
+    _release(id.index);
+    return true;
+}
+
+size_t TimerWheel::advance(Clock::time_point now)
+{
+    std::vector<Callback> due;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const std::uint64_t target =
+            now > start_ ? static_cast<std::uint64_t>((now - start_) / tick_)
+                         : 0;
+        if (armed_ == 0) {
+            // nothing to expire on the way
+            current_ = std::max(current_, target);
+        }
+        while (current_ < target) {
+            _step(due);
+        }
+        if (timerFd_) {
+            _rearm();
+        }
+    }
+    const size_t fired = due.size();
+    _dispatch(due);
+    return fired;
+}
+
+std::optional<TimerWheel::Clock::duration> TimerWheel::nextTimeout() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto tick = _nextDueTick();
+    if (!tick) {
+        return std::nullopt;
+    }
+    const auto at = start_
+                    + std::chrono::duration_cast<Clock::duration>(
+                        tick_ * static_cast<std::int64_t>(*tick));
+    return std::max(Clock::duration::zero(), at - Clock::now());
+}
+
+size_t TimerWheel::size() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return armed_;
+}
+
+void TimerWheel::attach(IReactor& reactor)
+{
+    if (reactor_ != nullptr) {
+        throw std::logic_error("TimerWheel is already attached");
+    }
+    auto timerFd = std::make_unique<TimerFd>();
+    const int fd = timerFd->fd();
+    reactor.add(fd, IoEvent::Readable, [this](int, IoEvent) {
+        timerFd_->drain();
+        advance();
+    });
+    reactor_ = &reactor;
+    std::lock_guard<std::mutex> lock(mutex_);
+    timerFd_ = std::move(timerFd);
+    armedTick_ = UINT64_MAX;
+    _rearm();
+}
+
+void TimerWheel::detach()
+{
+    if (reactor_ == nullptr) {
+        return;
+    }
+    reactor_->remove(timerFd_->fd());
+    reactor_ = nullptr;
+    std::lock_guard<std::mutex> lock(mutex_);
+    timerFd_.reset();
+}
+
+TimerWheel::TimerId TimerWheel::_add(Clock::duration delay,
+                                     Clock::duration period,
+                                     Callback cb)
+{
+    if (!cb) {
+        throw std::invalid_argument("TimerWheel callback is empty");
+    }
+    const auto now = Clock::now();
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::uint32_t index;
+    if (!free_.empty()) {
+        index = free_.back();
+        free_.pop_back();
+    }
+    else {
+        if (nodes_.size() >= kNil) {
+            throw std::length_error("TimerWheel is full");
+        }
+        nodes_.emplace_back();
+        index = static_cast<std::uint32_t>(nodes_.size() - 1);
+    }
+    Node& node = nodes_[index];
+    node.callback = std::move(cb);
+    node.expiry = std::max(_ticksUntil(now + delay), current_ + 1);
+    node.period = 0;
+    if (period > Clock::duration::zero()) {
+        node.period = std::max<std::uint64_t>(
+            1, _ticksUntil(start_ + period));
+    }
+    node.armed = true;
+    ++armed_;
+    _link(index);
+    if (timerFd_ && node.expiry < armedTick_) {
+        _rearm();
+    }
+    return TimerId{index, node.generation};
+}
+
+std::uint64_t TimerWheel::_ticksUntil(Clock::time_point t) const
+{
+    // round up: a timer never fires before its time
+    if (t <= start_) {
+        return 0;
+    }
+    const auto ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(t - start_);
+    return static_cast<std::uint64_t>((ns + tick_ - std::chrono::nanoseconds{1})
+                                      / tick_);
+}
+
+void TimerWheel::_link(std::uint32_t index)
+{
+    Node& node = nodes_[index];
+    // timers beyond the top wheel park in its farthest slot and are
+    // re-linked when they come down to wheel 0
+    const std::uint64_t delta =
+        std::min(node.expiry > current_ ? node.expiry - current_ : 0,
+                 kMaxDelta);
+    const std::uint64_t at = current_ + delta;
+    std::size_t level = 0;
+    while (level + 1 < kLevels
+           && delta >= (std::uint64_t{1} << (kSlotBits * (level + 1)))) {
+        ++level;
+    }
+    const std::size_t slot = (at >> (kSlotBits * level)) & (kSlots - 1);
+
+    std::uint32_t& head = heads_[level][slot];
+    node.slot = static_cast<std::uint16_t>(level * kSlots + slot);
+    node.prev = kNil;
+    node.next = head;
+    if (head != kNil) {
+        nodes_[head].prev = index;
+    }
+    head = index;
+}
+
+void TimerWheel::_unlink(std::uint32_t index)
+{
+    Node& node = nodes_[index];
+    if (node.prev != kNil) {
+        nodes_[node.prev].next = node.next;
+    }
+    else {
+        heads_[node.slot / kSlots][node.slot % kSlots] = node.next;
+    }
+    if (node.next != kNil) {
+        nodes_[node.next].prev = node.prev;
+    }
+    node.prev = kNil;
+    node.next = kNil;
+}
+
+void TimerWheel::_release(std::uint32_t index)
+{
+    Node& node = nodes_[index];
+    node.armed = false;
+    // stale TimerIds stop matching; skip 0, which marks an invalid id
+    if (++node.generation == 0) {
+        node.generation = 1;
+    }
+    --armed_;
+    free_.push_back(index);
+}
+
+void TimerWheel::_cascade(std::size_t level)
+{
+    const std::size_t slot =
+        (current_ >> (kSlotBits * level)) & (kSlots - 1);
+    std::uint32_t index = heads_[level][slot];
+    heads_[level][slot] = kNil;
+    while (index != kNil) {
+        const std::uint32_t next = nodes_[index].next;
+        _link(index);
+        index = next;
+    }
+}
+
+void TimerWheel::_step(std::vector<Callback>& due)
+{
+    ++current_;
+    // coarse wheels first, so what they hand down is cascaded further
+    for (std::size_t level = kLevels - 1; level > 0; --level) {
+        const std::uint64_t span = std::uint64_t{1} << (kSlotBits * level);
+        if ((current_ & (span - 1)) == 0) {
+            _cascade(level);
+        }
+    }
+
+    const std::size_t slot = current_ & (kSlots - 1);
+    std::uint32_t index = heads_[0][slot];
+    heads_[0][slot] = kNil;
+    while (index != kNil) {
+        Node& node = nodes_[index];
+        const std::uint32_t next = node.next;
+        if (node.expiry > current_) {
+            // parked beyond the top wheel, not due yet
+            _link(index);
+        }
+        else if (node.period != 0) {
+            due.push_back(node.callback);
+            node.expiry += node.period;
+            _link(index);
+        }
+        else {
+            due.push_back(std::move(node.callback));
+            node.callback = nullptr;
+            _release(index);
+        }
+        index = next;
+    }
+}
+
+std::optional<std::uint64_t> TimerWheel::_nextDueTick() const
+{
+    if (armed_ == 0) {
+        return std::nullopt;
+    }
+    // the next non-empty wheel-0 slot, or the next cascade, which may
+    // bring timers down from the coarse wheels
+    for (std::uint64_t t = current_ + 1;; ++t) {
+        if (heads_[0][t & (kSlots - 1)] != kNil || (t & (kSlots - 1)) == 0) {
+            return t;
+        }
+    }
+}
+
+void TimerWheel::_rearm()
+{
+    const auto tick = _nextDueTick();
+    if (!tick) {
+        timerFd_->disarm();
+        armedTick_ = UINT64_MAX;
+        return;
+    }
+    timerFd_->armAt(start_
+                    + std::chrono::duration_cast<Clock::duration>(
+                        tick_ * static_cast<std::int64_t>(*tick)));
+    armedTick_ = *tick;
+}
+
+void TimerWheel::_dispatch(std::vector<Callback>& due)
+{
+    WorkerPool* pool = pool_;
+    // one throwing callback does not cancel the others
+    std::exception_ptr error;
+    for (auto& cb : due) {
+        if (pool != nullptr) {
+            try {
+                // a copy: if the pool refuses it, cb still runs below
+                pool->addJob(cb);
+                continue;
+            }
+            catch (...) {
+                pool = nullptr; // stopped: the rest runs here too
+            }
+        }
+        try {
+            cb();
+        }
+        catch (...) {
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
@@ -1,26 +1,147 @@
 #include "threading/worker_pool.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace
+{
+
+// the pool and worker slot the calling thread belongs to, if any
+struct CurrentWorker
+{
+    const WorkerPool* pool = nullptr;
+    void* worker = nullptr;
+    WorkerStats* stats = nullptr;
+};
+
+thread_local CurrentWorker tlsCurrent;
+
+// Job nodes for the work-stealing deques. A node is taken from the cache of
+// the thread that pushes it and returned to the cache of the thread that
+// runs it, so steady-state spawning does not allocate.
+class NodeCache
+{
+public:
+    static constexpr size_t kMaxCached = 1024;
+
+    ~NodeCache()
+    {
+        for (Job* node : free_) {
+            delete node;
+        }
+    }
+
+    Job* acquire(Job&& job)
+    {
+        if (free_.empty()) {
+            return new Job(std::move(job));
+        }
+        Job* node = free_.back();
+        free_.pop_back();
+        *node = std::move(job);
+        return node;
+    }
+
+    Job release(Job* node)
+    {
+        Job job = std::move(*node);
+        if (free_.size() < kMaxCached) {
+            free_.push_back(node);
+        }
+        else {
+            delete node;
+        }
+        return job;
+    }
+
+private:
+    std::vector<Job*> free_;
+};
+
+thread_local NodeCache tlsNodes;
+
+// victim selection for threads helping from outside the pool
+thread_local std::uint64_t tlsStealRng = 0x2545F4914F6CDD1Dull;
+
+// job picks of this thread, drives the starvation protection
+thread_local size_t tlsPicks = 0;
+
+} // namespace
 
 WorkerPool::WorkerPool(size_t numberOfWorkers) :
-    numberOfWorkers_(numberOfWorkers)
+    WorkerPool(Options{.workers = numberOfWorkers})
+{
+}
+
+WorkerPool::WorkerPool(const Options& options) :
+    numberOfWorkers_(options.workers),
+    maxWorkers_(std::max(options.workers, options.maxWorkers)),
+    starvationLimit_(options.starvationLimit),
+    idleSpin_(options.idleSpin),
+    workersReady_(static_cast<std::ptrdiff_t>(options.workers)),
+    spawnLatency_(options.spawnLatency),
+    idleTimeout_(options.idleTimeout),
+    slotUsed_(maxWorkers_, false),
+    stampJobs_(_elastic() || options.metrics)
 {
-    // default number of worker threads
+    if (_elastic() && numberOfWorkers_ == 0) {
+        throw std::invalid_argument(
+            "An elastic WorkerPool needs at least one worker.");
+    }
+    if (options.metrics) {
+        stats_ = std::make_unique<WorkerStats[]>(maxWorkers_ + 1);
+    }
+    if (options.queueCapacity != 0) {
+        boundedQueue_ =
+            std::make_unique<BlockingMPMCQueue<Job>>(options.queueCapacity);
+    }
+    if (options.workStealing) {
+        // the initial workers fill in their own slots, see _run. Extra
+        // slots are visible to thieves all the time, so they exist up front.
+        locals_.resize(maxWorkers_);
+        for (size_t i = numberOfWorkers_; i < maxWorkers_; i++) {
+            locals_[i] = std::make_unique<Worker>();
+            locals_[i]->rng = 0x9E3779B97F4A7C15ull * (i + 1);
+        }
+    }
+    if (options.placement == Placement::Spread) {
+        cpus_ = CpuTopology::detect().spreadOrder();
+    }
+    else if (options.placement == Placement::Pack) {
+        cpus_ = CpuTopology::detect().packOrder();
+    }
+    workers_.resize(maxWorkers_);
+
     // create worker threads
-    for (size_t i = 0; i < numberOfWorkers_; i++) {
-        workers_.emplace_back(
-            std::make_unique<Thread>("worker_" + std::to_string(i), [this]() {
-                while (true) {
-                    // fetch job from the job queue
-                    auto job = jobQueue_.pop_front_optional();
-                    if (job.has_value() == false) {
-                        // job queue is closed and empty, exit the worker
-                        // thread
-                        break;
-                    }
-                    // execute the job
-                    job->get()->execute();
-                }
-            }));
-        workers_.back()->start();
+    size_t started = 0;
+    try {
+        for (size_t i = 0; i < numberOfWorkers_; i++) {
+            slotUsed_[i] = true;
+            _startWorker(i, true);
+            ++started;
+        }
+    }
+    catch (...) {
+        // release the workers already waiting for their siblings; the
+        // slots of the workers never started stay null, thieves skip them
+        workersReady_.count_down(
+            static_cast<std::ptrdiff_t>(numberOfWorkers_ - started));
+        stop();
+        throw;
+    }
+    workersReady_.wait();
+
+    if (_elastic()) {
+        // started last: it inspects the deques the workers just created
+        try {
+            monitor_ = std::make_unique<Thread>("pool_monitor", [this]() {
+                _monitor();
+            });
+            monitor_->start();
+        }
+        catch (...) {
+            stop();
+            throw;
+        }
     }
 }
 
@@ -29,31 +150,585 @@ WorkerPool::~WorkerPool()
     stop();
 }
 
-void WorkerPool::addJob(const std::function<void()>& jobToExecute)
+WorkerPool::BlockingScope::BlockingScope(WorkerPool& pool) :
+    pool_(tlsCurrent.pool == &pool ? &pool : nullptr)
 {
-    class JobImpl : public IJob
-    {
-    public:
-        JobImpl(const std::function<void()>& jobFunc) : jobFunc_(jobFunc) {}
-        void execute() override { jobFunc_(); }
+    if (pool_ == nullptr) {
+        return;
+    }
+    pool_->blocked_.fetch_add(1);
+    if (pool_->_elastic() && pool_->sleepers_.load() == 0) {
+        // nobody idle to take over our share of the queue
+        pool_->_spawnWorker(false);
+    }
+}
 
-    private:
-        std::function<void()> jobFunc_;
-    };
+WorkerPool::BlockingScope::~BlockingScope()
+{
+    if (pool_ != nullptr) {
+        pool_->blocked_.fetch_sub(1);
+    }
+}
 
-    // the job queue is thread-safe, just push the new job
-    jobQueue_.push_back(std::make_shared<JobImpl>(jobToExecute));
+void WorkerPool::addJob(std::unique_ptr<IJob> job)
+{
+    _push(Job([job = std::move(job)]() {
+                  job->execute();
+              }),
+          Priority::Normal);
+}
+
+void WorkerPool::waitIdle()
+{
+    if (tlsCurrent.pool == this) {
+        throw std::logic_error(
+            "WorkerPool::waitIdle() called from one of its own jobs");
+    }
+    idleWaiters_.fetch_add(1);
+    size_t n = pending_.load();
+    while (n != 0) {
+        pending_.wait(n);
+        n = pending_.load();
+    }
+    idleWaiters_.fetch_sub(1);
+}
+
+bool WorkerPool::runOneJob()
+{
+    Worker* self = _currentWorker();
+    Job job = _findJob(self);
+    if (!job && self == nullptr && !locals_.empty()) {
+        job = _steal(nullptr, tlsStealRng);
+    }
+    if (!job) {
+        return false;
+    }
+    _execute(job);
+    return true;
+}
+
+PoolMetrics WorkerPool::metrics() const
+{
+    PoolMetrics m;
+    m.pending = pending_.load();
+    m.queueDepth = highLane_.size.load() + backgroundLane_.size.load()
+                   + deadlineSize_.load()
+                   + (boundedQueue_ ? boundedQueue_->size_approx()
+                                    : jobQueue_.size());
+    for (const auto& w : locals_) {
+        if (w) {
+            m.queueDepth += w->deque.size_approx();
+        }
+    }
+    m.workers.resize(maxWorkers_);
+    {
+        std::lock_guard<std::mutex> lock(elasticMutex_);
+        for (size_t i = 0; i < maxWorkers_; ++i) {
+            m.workers[i].live = slotUsed_[i];
+        }
+    }
+    if (!stats_) {
+        return m;
+    }
+    for (size_t i = 0; i <= maxWorkers_; ++i) {
+        const WorkerStats& s = stats_[i];
+        s.queueLatency.addTo(m.queueLatency);
+        s.runTime.addTo(m.runTime);
+        if (i == maxWorkers_) {
+            m.helperJobs = s.jobs.load(std::memory_order_relaxed);
+            break;
+        }
+        auto& w = m.workers[i];
+        w.jobs = s.jobs.load(std::memory_order_relaxed);
+        w.busy = std::chrono::nanoseconds{s.busyNs.load()};
+        w.idle = std::chrono::nanoseconds{s.idleNs.load()};
+    }
+    return m;
 }
 
 void WorkerPool::joinAllWorkers()
 {
+    if (monitor_) {
+        monitor_->stop();
+    }
     for (auto& worker : workers_) {
-        worker->stop();
+        if (worker) {
+            worker->stop();
+        }
     }
 }
 
 void WorkerPool::stop()
 {
+    {
+        // no more spawns: workers_ stays as it is while we join it
+        std::lock_guard<std::mutex> lock(elasticMutex_);
+        elasticClosed_ = true;
+    }
+    // close every queue before workers may see stopping_: a job accepted
+    // after a worker found the queues empty would never run
+    if (boundedQueue_) {
+        boundedQueue_->close();
+    }
     jobQueue_.close();
+    highLane_.queue.close();
+    backgroundLane_.queue.close();
+    {
+        std::lock_guard<std::mutex> lock(deadlineMutex_);
+        deadlineClosed_ = true;
+    }
+    {
+        std::lock_guard<std::mutex> lock(parkMutex_);
+        stopping_.store(true);
+    }
+    parkCv_.notify_all();
+    monitorCv_.notify_all();
     joinAllWorkers();
 }
+
+void WorkerPool::_run(size_t index, bool initial)
+{
+    Worker* self = locals_.empty() ? nullptr : locals_[index].get();
+    if (initial) {
+        if (!locals_.empty()) {
+            // allocated here, after pinning: first touch on our NUMA node
+            locals_[index] = std::make_unique<Worker>();
+            self = locals_[index].get();
+            // distinct non-zero seeds for the victim selection
+            self->rng = 0x9E3779B97F4A7C15ull * (index + 1);
+        }
+        // nobody steals before every deque exists
+        workersReady_.arrive_and_wait();
+    }
+    tlsCurrent = CurrentWorker{this, self, stats_ ? &stats_[index] : nullptr};
+
+    IdleStrategy idle(idleSpin_);
+    while (true) {
+        // fetch job from the job queue (or our deque, or a victim's)
+        Job job = _findJob(self);
+        if (!job) {
+            job = _waitForJob(index, self, idle);
+        }
+        if (!job) {
+            // job queue is closed and empty (or we retired), exit the
+            // worker thread
+            break;
+        }
+        if (_elastic() && Clock::now() - job.queuedAt() > spawnLatency_) {
+            // jobs wait too long: add a worker
+            _spawnWorker(true);
+        }
+        // execute the job
+        _execute(job);
+    }
+    tlsCurrent = CurrentWorker{};
+}
+
+void WorkerPool::_execute(Job& job)
+{
+    WorkerStats* stats = nullptr;
+    if (stats_) {
+        stats = tlsCurrent.pool == this ? tlsCurrent.stats
+                                        : &stats_[maxWorkers_];
+    }
+    if (stats == nullptr) {
+        job();
+        job.reset();
+        _finished();
+        return;
+    }
+    const auto start = Clock::now();
+    stats->queueLatency.record(start - job.queuedAt());
+    job();
+    job.reset();
+    const auto ran = Clock::now() - start;
+    stats->runTime.record(ran);
+    stats->busyNs.fetch_add(ran.count(), std::memory_order_relaxed);
+    stats->jobs.fetch_add(1, std::memory_order_relaxed);
+    _finished();
+}
+
+Job WorkerPool::_waitForJob(size_t index, Worker* self, IdleStrategy& idle)
+{
+    const auto since = IdleStrategy::Clock::now();
+    Job job;
+    // spin, then yield: jobs pushed meanwhile are picked up without a
+    // wake-up since we are not counted in sleepers_
+    while (idle.step(since) && !stopping_.load(std::memory_order_relaxed)) {
+        if ((job = _findJob(self))) {
+            break;
+        }
+    }
+    while (!job) {
+        if (stopping_.load() && !_hasVisibleWork()) {
+            return Job{};
+        }
+        const bool woken = _park(_elastic() ? idleTimeout_
+                                            : std::chrono::nanoseconds{});
+        job = _findJob(self);
+        if (!job && !woken && _tryRetire(index)) {
+            return Job{};
+        }
+    }
+    const auto waited = IdleStrategy::Clock::now() - since;
+    idle.record(waited);
+    if (tlsCurrent.stats != nullptr) {
+        tlsCurrent.stats->idleNs.fetch_add(waited.count(),
+                                           std::memory_order_relaxed);
+    }
+    return job;
+}
+
+void WorkerPool::_startWorker(size_t index, bool initial)
+{
+    Thread::Options placement;
+    if (!cpus_.empty()) {
+        placement.cpus = {cpus_[index % cpus_.size()]};
+    }
+    // replacing a retired worker's Thread joins it; it already left _run
+    workers_[index] = std::make_unique<Thread>(
+        "worker_" + std::to_string(index),
+        [this, index, initial]() {
+            _run(index, initial);
+        },
+        std::move(placement));
+    liveWorkers_.fetch_add(1);
+    try {
+        workers_[index]->start();
+    }
+    catch (...) {
+        liveWorkers_.fetch_sub(1);
+        throw;
+    }
+}
+
+bool WorkerPool::_spawnWorker(bool throttled)
+{
+    const Clock::rep now = Clock::now().time_since_epoch().count();
+    if (throttled) {
+        // at most one latency-triggered spawn per spawnLatency
+        Clock::rep last = lastSpawn_.load(std::memory_order_relaxed);
+        if (now - last < spawnLatency_.count()
+            || !lastSpawn_.compare_exchange_strong(last, now)) {
+            return false;
+        }
+    }
+    std::lock_guard<std::mutex> lock(elasticMutex_);
+    if (elasticClosed_) {
+        return false;
+    }
+    auto slot = std::find(slotUsed_.begin(), slotUsed_.end(), false);
+    if (slot == slotUsed_.end()) {
+        return false;
+    }
+    const auto index = static_cast<size_t>(slot - slotUsed_.begin());
+    try {
+        _startWorker(index, false);
+    }
+    catch (const std::exception&) {
+        // out of threads or memory: keep working with what we have
+        return false;
+    }
+    slotUsed_[index] = true;
+    return true;
+}
+
+bool WorkerPool::_tryRetire(size_t index)
+{
+    std::lock_guard<std::mutex> lock(elasticMutex_);
+    // never drop below the minimum of runnable workers
+    const size_t live = liveWorkers_.load();
+    if (elasticClosed_ || live <= numberOfWorkers_ + blocked_.load()) {
+        return false;
+    }
+    // a job pushed while we were timing out may have found nobody to wake
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (_hasVisibleWork()) {
+        return false;
+    }
+    slotUsed_[index] = false;
+    liveWorkers_.fetch_sub(1);
+    return true;
+}
+
+void WorkerPool::_monitor()
+{
+    // covers what the workers cannot see: all of them stuck in long jobs
+    // while new jobs queue up
+    const auto tick = std::max<std::chrono::nanoseconds>(
+        spawnLatency_ / 4, std::chrono::microseconds(100));
+    bool backlog = false;
+    Clock::time_point backlogSince;
+    while (!stopping_.load()) {
+        {
+            std::unique_lock<std::mutex> lock(parkMutex_);
+            monitorCv_.wait_for(lock, tick, [this]() {
+                return stopping_.load();
+            });
+        }
+        if (sleepers_.load() != 0 || !_hasVisibleWork()) {
+            backlog = false;
+            continue;
+        }
+        const auto now = Clock::now();
+        if (!backlog) {
+            backlog = true;
+            backlogSince = now;
+        }
+        else if (now - backlogSince >= spawnLatency_) {
+            _spawnWorker(false);
+            backlog = false;
+        }
+    }
+}
+
+void WorkerPool::_push(Job job, Priority priority)
+{
+    if (stampJobs_) {
+        job.setQueuedAt(Clock::now());
+    }
+    pending_.fetch_add(1);
+    try {
+        _enqueue(std::move(job), priority);
+    }
+    catch (...) {
+        // closed queue: the job will never run
+        _finished();
+        throw;
+    }
+    _notifyWork();
+}
+
+void WorkerPool::_pushDeadline(Job job, Clock::time_point deadline)
+{
+    if (stampJobs_) {
+        job.setQueuedAt(Clock::now());
+    }
+    pending_.fetch_add(1);
+    {
+        std::lock_guard<std::mutex> lock(deadlineMutex_);
+        if (deadlineClosed_) {
+            _finished();
+            throw std::runtime_error(
+                "Cannot add a job to a stopped WorkerPool.");
+        }
+        try {
+            deadlineHeap_.push_back(
+                DeadlineJob{deadline, deadlineSeq_++, std::move(job)});
+        }
+        catch (...) {
+            _finished();
+            throw;
+        }
+        std::push_heap(deadlineHeap_.begin(), deadlineHeap_.end(), _runsAfter);
+        deadlineSize_.fetch_add(1);
+    }
+    _notifyWork();
+}
+
+void WorkerPool::_enqueue(Job job, Priority priority)
+{
+    if (priority != Priority::Normal) {
+        Lane& lane = priority == Priority::High ? highLane_ : backgroundLane_;
+        // counted before it is visible: size never drops below the number
+        // of queued jobs, so it cannot wrap and stop() cannot miss one
+        lane.size.fetch_add(1);
+        try {
+            lane.queue.push_back(std::move(job));
+        }
+        catch (...) {
+            lane.size.fetch_sub(1);
+            throw;
+        }
+        return;
+    }
+    Worker* self = _currentWorker();
+    if (self != nullptr) {
+        // spawned by one of our jobs: keep it local, idle workers can steal
+        self->deque.push(tlsNodes.acquire(std::move(job)));
+    }
+    else if (boundedQueue_) {
+        boundedQueue_->push(std::move(job));
+    }
+    else {
+        // the job queue is thread-safe, just push the new job
+        jobQueue_.push_back(std::move(job));
+    }
+}
+
+void WorkerPool::_finished()
+{
+    // seq_cst pairs with waitIdle(): either it sees the count drop or we
+    // see it waiting
+    if (pending_.fetch_sub(1) == 1 && idleWaiters_.load() != 0) {
+        pending_.notify_all();
+    }
+}
+
+Job WorkerPool::_findJob(Worker* self)
+{
+    if (starvationLimit_ != 0 && ++tlsPicks % starvationLimit_ == 0) {
+        // aging turn: lowest lane first
+        if (Job job = _popLane(backgroundLane_)) {
+            return job;
+        }
+        if (Job job = _findNormal(self)) {
+            return job;
+        }
+    }
+    if (Job job = _popLane(highLane_)) {
+        return job;
+    }
+    if (Job job = _popDeadline()) {
+        return job;
+    }
+    if (Job job = _findNormal(self)) {
+        return job;
+    }
+    return _popLane(backgroundLane_);
+}
+
+Job WorkerPool::_findNormal(Worker* self)
+{
+    if (self != nullptr) {
+        if (auto local = self->deque.pop()) {
+            return tlsNodes.release(*local);
+        }
+    }
+    if (Job job = _popInjector()) {
+        return job;
+    }
+    if (self != nullptr) {
+        return _steal(self, self->rng);
+    }
+    return Job{};
+}
+
+Job WorkerPool::_popLane(Lane& lane)
+{
+    if (lane.size.load(std::memory_order_relaxed) == 0) {
+        return Job{};
+    }
+    auto job = lane.queue.try_pop_front();
+    if (!job) {
+        return Job{};
+    }
+    lane.size.fetch_sub(1, std::memory_order_relaxed);
+    return std::move(*job);
+}
+
+Job WorkerPool::_popDeadline()
+{
+    if (deadlineSize_.load(std::memory_order_relaxed) == 0) {
+        return Job{};
+    }
+    std::lock_guard<std::mutex> lock(deadlineMutex_);
+    if (deadlineHeap_.empty()) {
+        return Job{};
+    }
+    std::pop_heap(deadlineHeap_.begin(), deadlineHeap_.end(), _runsAfter);
+    Job job = std::move(deadlineHeap_.back().job);
+    deadlineHeap_.pop_back();
+    deadlineSize_.fetch_sub(1, std::memory_order_relaxed);
+    return job;
+}
+
+bool WorkerPool::_runsAfter(const DeadlineJob& a, const DeadlineJob& b)
+{
+    // heap comparator: the top is the earliest deadline, oldest first
+    return a.deadline != b.deadline ? a.deadline > b.deadline : a.seq > b.seq;
+}
+
+Job WorkerPool::_popInjector()
+{
+    auto job = boundedQueue_ ? boundedQueue_->try_pop()
+                             : jobQueue_.try_pop_front();
+    return job ? std::move(*job) : Job{};
+}
+
+Job WorkerPool::_steal(Worker* self, std::uint64_t& rng)
+{
+    const size_t n = locals_.size();
+    // xorshift64: start at a random victim so thieves spread out
+    rng ^= rng << 13;
+    rng ^= rng >> 7;
+    rng ^= rng << 17;
+    const size_t start = static_cast<size_t>(rng % n);
+    for (size_t k = 0; k < n; ++k) {
+        Worker* victim = locals_[(start + k) % n].get();
+        if (victim == nullptr || victim == self) {
+            // null: the constructor failed before that worker started
+            continue;
+        }
+        if (auto stolen = victim->deque.steal()) {
+            return tlsNodes.release(*stolen);
+        }
+    }
+    return Job{};
+}
+
+bool WorkerPool::_hasVisibleWork() const
+{
+    if (highLane_.size.load() != 0 || backgroundLane_.size.load() != 0 ||
+        deadlineSize_.load() != 0) {
+        return true;
+    }
+    if (boundedQueue_ ? !boundedQueue_->empty() : !jobQueue_.empty()) {
+        return true;
+    }
+    for (const auto& w : locals_) {
+        if (w && !w->deque.empty()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkerPool::_notifyWork()
+{
+    // pairs with the fence in _park: either we see the sleeper or it sees
+    // the job we just published
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleepers_.load(std::memory_order_relaxed) == 0) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(parkMutex_);
+        ++wakeEpoch_;
+    }
+    parkCv_.notify_one();
+}
+
+bool WorkerPool::_park(std::chrono::nanoseconds timeout)
+{
+    std::unique_lock<std::mutex> lock(parkMutex_);
+    const std::uint64_t epoch = wakeEpoch_;
+    sleepers_.fetch_add(1);
+    lock.unlock();
+
+    bool woken = true;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!_hasVisibleWork() && !stopping_.load()) {
+        const auto wakeUp = [this, epoch]() {
+            return wakeEpoch_ != epoch || stopping_.load();
+        };
+        lock.lock();
+        if (timeout.count() == 0) {
+            parkCv_.wait(lock, wakeUp);
+        }
+        else {
+            woken = parkCv_.wait_for(lock, timeout, wakeUp);
+        }
+        lock.unlock();
+    }
+    sleepers_.fetch_sub(1);
+    return woken;
+}
+
+WorkerPool::Worker* WorkerPool::_currentWorker() const
+{
+    if (tlsCurrent.pool != this) {
+        return nullptr;
+    }
+    return static_cast<Worker*>(tlsCurrent.worker);
+}
@@ -0,0 +1,166 @@
+#include "iostream/async_log_sink.hpp"
+#include "iostream/thread_safe_iostream.hpp"
+#include <cstdio>
+#include <gtest/gtest.h>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+
+// anonymous temporary file the sink writes into
+struct TempFile
+{
+    std::FILE* file = std::tmpfile();
+
+    ~TempFile() { std::fclose(file); }
+
+    int fd() const { return ::fileno(file); }
+
+    std::vector<std::string> lines() const
+    {
+        std::string data;
+        char buf[4096];
+        ssize_t n;
+        off_t off = 0;
+        while ((n = ::pread(fd(), buf, sizeof(buf), off)) > 0) {
+            data.append(buf, static_cast<size_t>(n));
+            off += n;
+        }
+        std::vector<std::string> out;
+        std::istringstream is(data);
+        for (std::string line; std::getline(is, line);) {
+            out.push_back(line);
+        }
+        return out;
+    }
+};
+
+// "<thread> <seq>" lines: every sequence complete and in order per thread
+void expectOrderedPerThread(const std::vector<std::string>& lines,
+                            int threads, int perThread)
+{
+    ASSERT_EQ(lines.size(), static_cast<size_t>(threads * perThread));
+    std::map<std::string, int> next;
+    for (const auto& line : lines) {
+        std::istringstream is(line);
+        std::string who;
+        int seq = -1;
+        is >> who >> seq;
+        ASSERT_EQ(seq, next[who]) << line;
+        ++next[who];
+    }
+    EXPECT_EQ(next.size(), static_cast<size_t>(threads));
+}
+
+} // namespace
+
+TEST(AsyncLogSink, WritesEveryRecordInPushOrderPerThread)
+{
+    TempFile out;
+    const int threads = 4;
+    const int perThread = 5000;
+    std::uint64_t batches = 0;
+    {
+        AsyncLogSink sink(out.fd(), 256);
+        EXPECT_EQ(sink.capacity(), 256u);
+        std::vector<std::thread> producers;
+        for (int t = 0; t < threads; ++t) {
+            producers.emplace_back([&sink, t]() {
+                for (int i = 0; i < perThread; ++i) {
+                    sink.push("t" + std::to_string(t) + " "
+                              + std::to_string(i) + "\n");
+                }
+            });
+        }
+        for (auto& p : producers) {
+            p.join();
+        }
+        sink.drain();
+        EXPECT_EQ(sink.written(), static_cast<std::uint64_t>(threads
+                                                             * perThread));
+        batches = sink.batches();
+    }
+    EXPECT_GT(batches, 0u);
+    EXPECT_LE(batches, static_cast<std::uint64_t>(threads * perThread));
+    expectOrderedPerThread(out.lines(), threads, perThread);
+}
+
+TEST(AsyncLogSink, FullRingBlocksProducersWithoutDroppingLines)
+{
+    TempFile out;
+    {
+        AsyncLogSink sink(out.fd(), 2);
+        std::vector<std::thread> producers;
+        for (int t = 0; t < 3; ++t) {
+            producers.emplace_back([&sink, t]() {
+                for (int i = 0; i < 1000; ++i) {
+                    sink.push("p" + std::to_string(t) + " "
+                              + std::to_string(i) + "\n");
+                }
+            });
+        }
+        for (auto& p : producers) {
+            p.join();
+        }
+        // the destructor writes what is left
+    }
+    expectOrderedPerThread(out.lines(), 3, 1000);
+}
+
+TEST(AsyncLogSink, ThreadSafeIOStreamAsyncModeKeepsLinesWhole)
+{
+    TempFile out;
+    ThreadSafeIOStream::enableAsync(out.fd());
+    EXPECT_TRUE(ThreadSafeIOStream::isAsync());
+    EXPECT_THROW(ThreadSafeIOStream::enableAsync(out.fd()), std::logic_error);
+
+    std::ostringstream captured;
+    std::streambuf* old = std::cout.rdbuf(captured.rdbuf());
+    const int threads = 4;
+    const int perThread = 2000;
+    std::vector<std::thread> loggers;
+    for (int t = 0; t < threads; ++t) {
+        loggers.emplace_back([t]() {
+            threadSafeCout.setPrefix("w" + std::to_string(t) + " ");
+            for (int i = 0; i < perThread; ++i) {
+                threadSafeCout << i << '\n';
+            }
+            threadSafeCout.flush();
+        });
+    }
+    for (auto& l : loggers) {
+        l.join();
+    }
+    ThreadSafeIOStream::disableAsync();
+    std::cout.rdbuf(old);
+
+    EXPECT_FALSE(ThreadSafeIOStream::isAsync());
+    EXPECT_TRUE(captured.str().empty()) << "async lines bypass std::cout";
+    expectOrderedPerThread(out.lines(), threads, perThread);
+}
+
+TEST(AsyncLogSink, AsyncFlushWritesThePartialLine)
+{
+    TempFile out;
+    ThreadSafeIOStream::enableAsync(out.fd());
+    std::thread t([]() {
+        threadSafeCout.setPrefix("[F] ");
+        threadSafeCout << "A\nB\nparti";
+        threadSafeCout << "al";
+        threadSafeCout.flush();
+    });
+    t.join();
+    const auto lines = out.lines(); // flush() waited for the writer
+    ThreadSafeIOStream::disableAsync();
+
+    ASSERT_EQ(lines.size(), 3u);
+    EXPECT_EQ(lines[0], "[F] A");
+    EXPECT_EQ(lines[1], "[F] B");
+    EXPECT_EQ(lines[2], "[F] partial");
+}
@@ -0,0 +1,78 @@
+// tests/cpu_topology_test.cpp
+#include "threading/cpu_topology.hpp"
+#include "threading/worker_pool.hpp"
+#include <atomic>
+#include <gtest/gtest.h>
+#include <pthread.h>
+#include <sched.h>
+#include <vector>
+
+namespace
+{
+
+// 2 packages x 2 cores x 2 hyper-threads, cpu = p*4 + c*2 + t
+CpuTopology dualSocket()
+{
+    std::vector<CpuTopology::Cpu> cpus;
+    for (int p = 0; p < 2; ++p) {
+        for (int c = 0; c < 2; ++c) {
+            for (int t = 0; t < 2; ++t) {
+                cpus.push_back({p * 4 + c * 2 + t, c, p, p});
+            }
+        }
+    }
+    return CpuTopology(cpus);
+}
+
+} // namespace
+
+TEST(CpuTopologyTest, SpreadAlternatesPackagesAndAvoidsSiblings)
+{
+    EXPECT_EQ(dualSocket().spreadOrder(),
+              (std::vector<int>{0, 4, 2, 6, 1, 5, 3, 7}));
+}
+
+TEST(CpuTopologyTest, PackFillsCoresThenPackages)
+{
+    EXPECT_EQ(dualSocket().packOrder(),
+              (std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7}));
+    EXPECT_EQ(dualSocket().nodeCount(), 2u);
+}
+
+TEST(CpuTopologyTest, DetectListsAllowedCpus)
+{
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    ASSERT_EQ(sched_getaffinity(0, sizeof(allowed), &allowed), 0);
+
+    auto topology = CpuTopology::detect();
+    ASSERT_EQ(topology.cpus().size(),
+              static_cast<size_t>(CPU_COUNT(&allowed)));
+    for (const auto& cpu : topology.cpus()) {
+        EXPECT_TRUE(CPU_ISSET(cpu.id, &allowed));
+    }
+    EXPECT_GE(topology.nodeCount(), 1u);
+    EXPECT_EQ(topology.spreadOrder().size(), topology.cpus().size());
+}
+
+TEST(CpuTopologyTest, PinnedWorkerPoolRunsOnSingleCpus)
+{
+    for (auto placement :
+         {WorkerPool::Placement::Spread, WorkerPool::Placement::Pack}) {
+        WorkerPool pool(WorkerPool::Options{
+            .workers = 3, .workStealing = true, .placement = placement});
+        std::atomic<int> pinned{0};
+        for (int i = 0; i < 12; ++i) {
+            pool.addJob([&]() {
+                cpu_set_t set;
+                CPU_ZERO(&set);
+                pthread_getaffinity_np(pthread_self(), sizeof(set), &set);
+                if (CPU_COUNT(&set) == 1) {
+                    pinned.fetch_add(1);
+                }
+            });
+        }
+        pool.waitIdle();
+        EXPECT_EQ(pinned.load(), 12);
+    }
+}
@@ -0,0 +1,140 @@
+// tests/elastic_pool_test.cpp
+#include "threading/parallel.hpp"
+#include "threading/worker_pool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+
+template <class Pred> bool eventually(Pred pred, std::chrono::seconds timeout)
+{
+    const auto until = std::chrono::steady_clock::now() + timeout;
+    while (!pred()) {
+        if (std::chrono::steady_clock::now() > until) {
+            return false;
+        }
+        std::this_thread::sleep_for(1ms);
+    }
+    return true;
+}
+
+} // namespace
+
+TEST(ElasticPoolTest, GrowsUnderLoadAndShrinksWhenIdle)
+{
+    WorkerPool pool(WorkerPool::Options{.workers = 1,
+                                        .maxWorkers = 4,
+                                        .spawnLatency = 1ms,
+                                        .idleTimeout = 50ms});
+    EXPECT_EQ(pool.workerCount(), 1u);
+
+    std::atomic<size_t> peak{0};
+    for (int i = 0; i < 12; ++i) {
+        pool.addJob([&]() {
+            std::this_thread::sleep_for(10ms);
+            size_t now = pool.workerCount();
+            size_t seen = peak.load();
+            while (now > seen && !peak.compare_exchange_weak(seen, now)) {
+            }
+        });
+    }
+    pool.waitIdle();
+    EXPECT_GT(peak.load(), 1u);
+    EXPECT_LE(peak.load(), 4u);
+
+    EXPECT_TRUE(eventually(
+        [&]() {
+            return pool.workerCount() == 1;
+        },
+        5s));
+}
+
+TEST(ElasticPoolTest, MonitorSpawnsWhenAllWorkersAreStuck)
+{
+    WorkerPool pool(WorkerPool::Options{
+        .workers = 1, .maxWorkers = 2, .spawnLatency = 2ms});
+    std::atomic<bool> release{false};
+    std::atomic<bool> secondRan{false};
+
+    pool.addJob([&]() {
+        // long job without BlockingScope: only the monitor can notice
+        eventually(
+            [&]() {
+                return release.load();
+            },
+            5s);
+    });
+    pool.addJob([&]() {
+        secondRan.store(true);
+    });
+    EXPECT_TRUE(eventually(
+        [&]() {
+            return secondRan.load();
+        },
+        5s));
+    release.store(true);
+    pool.waitIdle();
+}
+
+TEST(ElasticPoolTest, BlockingScopeSpawnsStandIn)
+{
+    // a huge spawnLatency: the stand-in can only come from BlockingScope
+    WorkerPool pool(WorkerPool::Options{
+        .workers = 1, .maxWorkers = 2, .spawnLatency = 1h});
+    std::atomic<bool> replied{false};
+    bool sawReply = false;
+
+    pool.addJob([&]() {
+        WorkerPool::BlockingScope blocking(pool);
+        sawReply = eventually(
+            [&]() {
+                return replied.load();
+            },
+            5s);
+    });
+    pool.addJob([&]() {
+        replied.store(true);
+    });
+    pool.waitIdle();
+    EXPECT_TRUE(sawReply);
+    EXPECT_EQ(pool.workerCount(), 2u);
+}
+
+TEST(ElasticPoolTest, WorkStealingElasticPoolCompletesNestedWork)
+{
+    WorkerPool pool(WorkerPool::Options{.workers = 1,
+                                        .workStealing = true,
+                                        .maxWorkers = 3,
+                                        .spawnLatency = 1ms,
+                                        .idleTimeout = 20ms});
+    std::atomic<int> cells{0};
+    for (int round = 0; round < 3; ++round) {
+        parallel_for(pool, 0, 64, 1, [&](size_t) {
+            std::this_thread::sleep_for(100us);
+            cells.fetch_add(1);
+        });
+        std::this_thread::sleep_for(30ms);
+    }
+    EXPECT_EQ(cells.load(), 3 * 64);
+}
+
+TEST(ElasticPoolTest, RejectsEmptyElasticPoolAndIgnoresForeignScopes)
+{
+    EXPECT_THROW(WorkerPool(WorkerPool::Options{.workers = 0,
+                                                .maxWorkers = 2}),
+                 std::invalid_argument);
+
+    WorkerPool pool(WorkerPool::Options{.workers = 1, .maxWorkers = 2});
+    {
+        // not one of the pool's jobs: nothing to compensate
+        WorkerPool::BlockingScope blocking(pool);
+    }
+    EXPECT_EQ(pool.workerCount(), 1u);
+}
@@ -0,0 +1,219 @@
+// tests/enum_state_batch_test.cpp
+#include "design_patterns/enum_state_batch.hpp"
+#include "threading/worker_pool.hpp"
+#include <functional>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+
+enum class Mob : std::uint8_t
+{
+    Idle,
+    Chase,
+    Flee,
+    Dead
+};
+
+struct Entity
+{
+    int idle_ticks{0};
+    int chase_ticks{0};
+    int flee_ticks{0};
+    int transitions{0};
+};
+
+constexpr auto kMob = EnumStateTable<Mob, 4, Entity>{}
+                          .action(Mob::Idle,
+                                  [](Entity& e) {
+                                      e.idle_ticks++;
+                                  })
+                          .action(Mob::Chase,
+                                  [](Entity& e) {
+                                      e.chase_ticks++;
+                                  })
+                          .action(Mob::Flee,
+                                  [](Entity& e) {
+                                      e.flee_ticks++;
+                                  })
+                          .transition(Mob::Idle,
+                                      Mob::Chase,
+                                      [](Entity& e) {
+                                          e.transitions++;
+                                      })
+                          .transition(Mob::Chase,
+                                      Mob::Flee,
+                                      [](Entity& e) {
+                                          e.transitions++;
+                                      })
+                          .transition(Mob::Chase, Mob::Dead, [](Entity& e) {
+                              e.transitions++;
+                          });
+
+using MobBatch = EnumStateBatch<kMob>;
+
+} // namespace
+
+TEST(EnumStateBatchTest, UpdateAllRunsActionOfEachInstanceState)
+{
+    MobBatch batch;
+    std::vector<Entity> entities(6);
+
+    for (int i = 0; i < 6; ++i) {
+        batch.add(Mob::Idle);
+    }
+    batch.transitionTo(1, Mob::Chase, entities[1]);
+    batch.transitionTo(4, Mob::Chase, entities[4]);
+    batch.transitionTo(4, Mob::Flee, entities[4]);
+
+    EXPECT_EQ(batch.countIn(Mob::Idle), 4u);
+    EXPECT_EQ(batch.countIn(Mob::Chase), 1u);
+    EXPECT_EQ(batch.countIn(Mob::Flee), 1u);
+
+    batch.updateAll(entities);
+    batch.updateAll(entities);
+
+    EXPECT_EQ(entities[0].idle_ticks, 2);
+    EXPECT_EQ(entities[1].chase_ticks, 2);
+    EXPECT_EQ(entities[1].idle_ticks, 0);
+    EXPECT_EQ(entities[4].flee_ticks, 2);
+    EXPECT_EQ(entities[4].transitions, 2);
+    EXPECT_EQ(batch.state(4), Mob::Flee);
+}
+
+TEST(EnumStateBatchTest, ManyInstancesAreGroupedByState)
+{
+    MobBatch batch;
+    batch.reserve(100000);
+    for (int i = 0; i < 100000; ++i) {
+        batch.add(Mob::Idle);
+    }
+    EXPECT_EQ(batch.size(), 100000u);
+    EXPECT_EQ(batch.countIn(Mob::Idle), 100000u);
+}
+
+TEST(EnumStateBatchTest, MissingTransition_ThrowsAndKeepsState)
+{
+    MobBatch batch;
+    Entity e;
+    auto id = batch.add(Mob::Idle);
+
+    EXPECT_THROW(batch.transitionTo(id, Mob::Dead, e), std::runtime_error);
+    EXPECT_EQ(batch.state(id), Mob::Idle);
+}
+
+TEST(EnumStateBatchTest, StateWithoutAction_ThrowsBeforeRunningAnything)
+{
+    MobBatch batch;
+    std::vector<Entity> entities(2);
+
+    batch.add(Mob::Idle);
+    auto id = batch.add(Mob::Chase);
+    batch.transitionTo(id, Mob::Dead, entities[1]);
+
+    EXPECT_THROW(batch.updateAll(entities), std::runtime_error);
+    EXPECT_EQ(entities[0].idle_ticks, 0);
+}
+
+TEST(EnumStateBatchTest, ContextCountMismatch_Throws)
+{
+    MobBatch batch;
+    std::vector<Entity> entities(1);
+
+    batch.add(Mob::Idle);
+    batch.add(Mob::Idle);
+    EXPECT_THROW(batch.updateAll(entities), std::invalid_argument);
+}
+
+TEST(EnumStateBatchTest, ParallelUpdateOnWorkerPoolMatchesSerial)
+{
+    const int n = 10000;
+    MobBatch batch;
+    std::vector<Entity> entities(n);
+
+    for (int i = 0; i < n; ++i) {
+        auto id = batch.add(Mob::Idle);
+        if (i % 3 == 0) {
+            batch.transitionTo(id, Mob::Chase, entities[i]);
+        }
+    }
+
+    WorkerPool pool(4);
+    batch.updateAll(entities, pool, 256);
+    batch.updateAll(entities, pool, 256);
+
+    for (int i = 0; i < n; ++i) {
+        if (i % 3 == 0) {
+            ASSERT_EQ(entities[i].chase_ticks, 2) << "instance " << i;
+            ASSERT_EQ(entities[i].idle_ticks, 0) << "instance " << i;
+        }
+        else {
+            ASSERT_EQ(entities[i].idle_ticks, 2) << "instance " << i;
+        }
+    }
+}
+
+TEST(EnumStateBatchTest, ParallelUpdateFromInsidePoolJobsHelpsInstead)
+{
+    // every worker calls updateAll; waiting without helping would leave
+    // nobody to run the chunks
+    const int n = 1000;
+    WorkerPool pool(2);
+    std::vector<MobBatch> batches(4);
+    std::vector<std::vector<Entity>> entities(4, std::vector<Entity>(n));
+    for (auto& batch : batches) {
+        for (int i = 0; i < n; ++i) {
+            batch.add(Mob::Idle);
+        }
+    }
+    for (std::size_t b = 0; b < batches.size(); ++b) {
+        pool.addJob([&, b]() {
+            batches[b].updateAll(entities[b], pool, 100);
+        });
+    }
+    pool.waitIdle();
+    for (const auto& list : entities) {
+        for (const auto& e : list) {
+            ASSERT_EQ(e.idle_ticks, 1);
+        }
+    }
+}
+
+TEST(EnumStateBatchTest, ExecutorFailurePartwayWaitsForQueuedJobs)
+{
+    // accepts three jobs, then refuses; the accepted ones run later
+    struct FlakyExecutor
+    {
+        WorkerPool& pool;
+        int accepted = 0;
+
+        void addJob(std::function<void()> job)
+        {
+            if (accepted == 3) {
+                throw std::runtime_error("executor full");
+            }
+            ++accepted;
+            pool.addJob(std::move(job));
+        }
+    };
+
+    const int n = 1000;
+    MobBatch batch;
+    std::vector<Entity> entities(n);
+    for (int i = 0; i < n; ++i) {
+        batch.add(Mob::Idle);
+    }
+
+    WorkerPool pool(2);
+    FlakyExecutor executor{pool};
+    EXPECT_THROW(batch.updateAll(entities, executor, 100), std::runtime_error);
+    pool.waitIdle();
+
+    int ran = 0;
+    for (const auto& e : entities) {
+        ran += e.idle_ticks;
+    }
+    EXPECT_EQ(ran, 300);
+}
@@ -0,0 +1,145 @@
+// tests/enum_state_machine_test.cpp
+#include "design_patterns/enum_state_machine.hpp"
+#include <gtest/gtest.h>
+#include <stdexcept>
+
+namespace
+{
+
+enum class Light : std::uint8_t
+{
+    Red,
+    Green,
+    Yellow,
+    Blink
+};
+
+struct Counters
+{
+    int red_updates{0};
+    int green_updates{0};
+    int yellow_updates{0};
+    int transition_calls{0};
+};
+
+constexpr auto kTrafficLight =
+    EnumStateTable<Light, 4, Counters>{}
+        .action(Light::Red,
+                [](Counters& c) {
+                    c.red_updates++;
+                })
+        .action(Light::Green,
+                [](Counters& c) {
+                    c.green_updates++;
+                })
+        .action(Light::Yellow,
+                [](Counters& c) {
+                    c.yellow_updates++;
+                })
+        .transition(Light::Red,
+                    Light::Green,
+                    [](Counters& c) {
+                        c.transition_calls++;
+                    })
+        .transition(Light::Green,
+                    Light::Yellow,
+                    [](Counters& c) {
+                        c.transition_calls++;
+                    })
+        .transition(Light::Yellow, Light::Red, [](Counters& c) {
+            c.transition_calls++;
+        });
+
+using TrafficLight = EnumStateMachine<kTrafficLight>;
+
+} // namespace
+
+TEST(EnumStateMachineTest, TableIsBuiltAtCompileTime)
+{
+    static_assert(kTrafficLight.hasTransition(Light::Red, Light::Green));
+    static_assert(!kTrafficLight.hasTransition(Light::Red, Light::Yellow));
+    static_assert(kTrafficLight.hasAction(Light::Yellow));
+    static_assert(!kTrafficLight.hasAction(Light::Blink));
+    // an instance only stores its current state
+    static_assert(sizeof(TrafficLight) == 1);
+}
+
+TEST(EnumStateMachineTest, InitialStateDoesNotRunAnyCallback)
+{
+    Counters c;
+    TrafficLight sm(Light::Red);
+
+    EXPECT_EQ(sm.current(), Light::Red);
+    EXPECT_EQ(c.transition_calls, 0);
+
+    sm.update(c);
+    EXPECT_EQ(c.red_updates, 1);
+}
+
+TEST(EnumStateMachineTest, HappyPath_CycleRedGreenYellowBackToRed)
+{
+    Counters c;
+    TrafficLight sm(Light::Red);
+
+    sm.transitionTo(Light::Green, c);
+    sm.update(c);
+    sm.transitionTo(Light::Yellow, c);
+    sm.update(c);
+    sm.transitionTo(Light::Red, c);
+    sm.update(c);
+
+    EXPECT_EQ(c.transition_calls, 3);
+    EXPECT_EQ(c.green_updates, 1);
+    EXPECT_EQ(c.yellow_updates, 1);
+    EXPECT_EQ(c.red_updates, 1);
+    EXPECT_EQ(sm.current(), Light::Red);
+}
+
+TEST(EnumStateMachineTest, TransitionToCurrentStateIsNoop)
+{
+    Counters c;
+    TrafficLight sm(Light::Green);
+
+    sm.transitionTo(Light::Green, c);
+    EXPECT_EQ(c.transition_calls, 0);
+}
+
+TEST(EnumStateMachineTest, MissingTransition_ThrowsAndKeepsState)
+{
+    Counters c;
+    TrafficLight sm(Light::Red);
+
+    EXPECT_THROW(sm.transitionTo(Light::Yellow, c), std::runtime_error);
+    EXPECT_EQ(sm.current(), Light::Red);
+    EXPECT_EQ(c.transition_calls, 0);
+}
+
+TEST(EnumStateMachineTest, MissingAction_ThrowsOnUpdate)
+{
+    Counters c;
+    TrafficLight sm(Light::Blink);
+
+    EXPECT_THROW(sm.update(c), std::runtime_error);
+}
+
+TEST(EnumStateMachineTest, OutOfRangeState_Throws)
+{
+    Counters c;
+    TrafficLight sm(Light::Red);
+
+    EXPECT_THROW(sm.transitionTo(static_cast<Light>(9), c), std::out_of_range);
+    EXPECT_THROW(TrafficLight(static_cast<Light>(4)), std::out_of_range);
+}
+
+TEST(EnumStateMachineTest, ManyInstancesShareOneTable)
+{
+    Counters c;
+    std::vector<TrafficLight> lights(1000, TrafficLight(Light::Red));
+
+    for (auto& sm : lights) {
+        sm.transitionTo(Light::Green, c);
+        sm.update(c);
+    }
+    EXPECT_EQ(c.transition_calls, 1000);
+    EXPECT_EQ(c.green_updates, 1000);
+}
@@ -0,0 +1,126 @@
+// tests/future_test.cpp
+#include "threading/future.hpp"
+#include "threading/worker_pool.hpp"
+#include <atomic>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(WorkerPoolSubmitTest, ReturnsResultThroughFuture)
+{
+    WorkerPool pool(2);
+    Future<int> f = pool.submit(
+        [](int a, int b) {
+            return a * b;
+        },
+        6,
+        7);
+    EXPECT_TRUE(f.valid());
+    EXPECT_EQ(f.get(), 42);
+    EXPECT_FALSE(f.valid());
+    EXPECT_THROW(f.get(), std::logic_error);
+}
+
+TEST(WorkerPoolSubmitTest, ArgumentsAreCopiedAndMoveOnlyResultsWork)
+{
+    WorkerPool pool(2);
+    std::string text = "abc";
+    auto f = pool.submit(
+        [](std::string& s) {
+            s += "d";
+            return std::make_unique<std::string>(s);
+        },
+        text);
+    EXPECT_EQ(*f.get(), "abcd");
+    EXPECT_EQ(text, "abc") << "arguments are decay-copied";
+}
+
+TEST(WorkerPoolSubmitTest, ExceptionIsRethrownByGet)
+{
+    WorkerPool pool(1);
+    auto f = pool.submit([]() {
+        throw std::runtime_error("boom");
+    });
+    f.wait();
+    EXPECT_TRUE(f.ready());
+    EXPECT_THROW(f.get(), std::runtime_error);
+
+    // the worker survived the throwing job
+    auto next = pool.submit([]() {
+        return 5;
+    });
+    EXPECT_EQ(next.get(), 5);
+}
+
+TEST(WorkerPoolSubmitTest, ForkJoinFromManyThreads)
+{
+    WorkerPool pool(WorkerPool::Options{.workers = 4, .workStealing = true});
+    std::vector<std::thread> clients;
+    std::atomic<long> total{0};
+    for (int c = 0; c < 4; ++c) {
+        clients.emplace_back([&, c]() {
+            std::vector<Future<long>> parts;
+            for (long i = 0; i < 50; ++i) {
+                parts.push_back(pool.submit(
+                    [](long x) {
+                        return x * x;
+                    },
+                    i + c));
+            }
+            for (auto& p : parts) {
+                total.fetch_add(p.get());
+            }
+        });
+    }
+    for (auto& t : clients) {
+        t.join();
+    }
+    long expected = 0;
+    for (int c = 0; c < 4; ++c) {
+        for (long i = 0; i < 50; ++i) {
+            expected += (i + c) * (i + c);
+        }
+    }
+    EXPECT_EQ(total.load(), expected);
+}
+
+TEST(WorkerPoolWaitIdleTest, WaitsForQueuedAndSpawnedJobsWithoutStopping)
+{
+    WorkerPool pool(WorkerPool::Options{.workers = 3, .workStealing = true});
+    std::atomic<int> done{0};
+
+    for (int round = 1; round <= 3; ++round) {
+        for (int i = 0; i < 20; ++i) {
+            pool.addJob([&pool, &done]() {
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+                pool.addJob([&done]() {
+                    done.fetch_add(1);
+                });
+                done.fetch_add(1);
+            });
+        }
+        pool.waitIdle();
+        EXPECT_EQ(done.load(), round * 40);
+    }
+}
+
+TEST(WorkerPoolWaitIdleTest, ReturnsImmediatelyWhenIdleAndRejectsWorkers)
+{
+    WorkerPool pool(2);
+    pool.waitIdle();
+
+    auto f = pool.submit([&pool]() {
+        try {
+            pool.waitIdle();
+        }
+        catch (const std::logic_error&) {
+            return true;
+        }
+        return false;
+    });
+    EXPECT_TRUE(f.get());
+}
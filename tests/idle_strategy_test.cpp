@@ -0,0 +1,70 @@
+// tests/idle_strategy_test.cpp
+#include "threading/idle_strategy.hpp"
+#include "threading/worker_pool.hpp"
+#include <atomic>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+TEST(IdleStrategyTest, BudgetFollowsShortGaps)
+{
+    IdleStrategy idle(100us);
+    EXPECT_EQ(idle.budget(), 100us);
+    for (int i = 0; i < 64; ++i) {
+        idle.record(10us);
+    }
+    EXPECT_GT(idle.averageGap(), 9us);
+    EXPECT_LE(idle.averageGap(), 10us);
+    EXPECT_EQ(idle.budget(), 2 * idle.averageGap());
+}
+
+TEST(IdleStrategyTest, LongGapsParkRightAway)
+{
+    IdleStrategy idle(50us);
+    for (int i = 0; i < 64; ++i) {
+        idle.record(5ms);
+    }
+    EXPECT_EQ(idle.budget(), 0ns);
+    EXPECT_FALSE(idle.step(IdleStrategy::Clock::now()));
+
+    // traffic picks up again: the budget comes back
+    for (int i = 0; i < 64; ++i) {
+        idle.record(1us);
+    }
+    EXPECT_GT(idle.budget(), 0ns);
+}
+
+TEST(IdleStrategyTest, StepStopsOnceBudgetIsSpent)
+{
+    IdleStrategy disabled;
+    EXPECT_FALSE(disabled.step(IdleStrategy::Clock::now()));
+
+    IdleStrategy idle(200us);
+    const auto since = IdleStrategy::Clock::now();
+    int steps = 0;
+    while (idle.step(since)) {
+        ++steps;
+    }
+    EXPECT_GT(steps, 0);
+    EXPECT_GE(IdleStrategy::Clock::now() - since, 200us);
+}
+
+TEST(IdleStrategyTest, SpinningPoolRunsJobsAndStops)
+{
+    std::atomic<int> done{0};
+    {
+        WorkerPool pool(WorkerPool::Options{.workers = 2, .idleSpin = 20us});
+        for (int round = 0; round < 20; ++round) {
+            for (int i = 0; i < 10; ++i) {
+                pool.addJob([&]() {
+                    done.fetch_add(1);
+                });
+            }
+            pool.waitIdle();
+            std::this_thread::sleep_for(50us);
+        }
+    }
+    EXPECT_EQ(done.load(), 200);
+}
@@ -0,0 +1,125 @@
+// tests/job_test.cpp
+#include "threading/job.hpp"
+#include "threading/worker_pool.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <gtest/gtest.h>
+#include <memory>
+#include <thread>
+
+namespace
+{
+
+struct LifeCounter
+{
+    static int alive;
+    LifeCounter() { ++alive; }
+    LifeCounter(const LifeCounter&) { ++alive; }
+    LifeCounter(LifeCounter&&) noexcept { ++alive; }
+    ~LifeCounter() { --alive; }
+};
+
+int LifeCounter::alive = 0;
+
+} // namespace
+
+TEST(JobTest, SmallLambdasAreStoredInline)
+{
+    int a = 0;
+    int b = 0;
+    auto small = [&a, &b, x = 3]() {
+        a += x;
+        b -= x;
+    };
+    static_assert(Job::storesInline<decltype(small)>());
+    static_assert(Job::storesInline<std::function<void()>>());
+    static_assert(sizeof(Job) == 64);
+
+    Job job(small);
+    ASSERT_TRUE(job);
+    job();
+    EXPECT_EQ(a, 3);
+    EXPECT_EQ(b, -3);
+}
+
+TEST(JobTest, LargeCallablesFallBackToHeap)
+{
+    std::array<long, 32> big{};
+    big[31] = 5;
+    long out = 0;
+    auto fn = [big, &out]() {
+        out = big[31];
+    };
+    static_assert(!Job::storesInline<decltype(fn)>());
+
+    Job job(fn);
+    Job moved(std::move(job));
+    EXPECT_FALSE(job);
+    moved();
+    EXPECT_EQ(out, 5);
+}
+
+TEST(JobTest, HoldsMoveOnlyCapturesAndDestroysThem)
+{
+    LifeCounter::alive = 0;
+    {
+        auto owned = std::make_unique<int>(7);
+        int seen = 0;
+        Job job([p = std::move(owned), &seen, c = LifeCounter{}]() {
+            seen = *p;
+        });
+        EXPECT_EQ(LifeCounter::alive, 1);
+
+        Job other;
+        other = std::move(job);
+        EXPECT_EQ(LifeCounter::alive, 1);
+        other();
+        EXPECT_EQ(seen, 7);
+        other.reset();
+        EXPECT_EQ(LifeCounter::alive, 0);
+    }
+    EXPECT_EQ(LifeCounter::alive, 0);
+}
+
+TEST(JobTest, WorkerPoolRunsMoveOnlyJobs)
+{
+    std::promise<int> promise;
+    auto result = promise.get_future();
+    {
+        WorkerPool pool(2);
+        pool.addJob([p = std::move(promise)]() mutable {
+            p.set_value(11);
+        });
+        ASSERT_EQ(result.wait_for(std::chrono::seconds(5)),
+                  std::future_status::ready);
+    }
+    EXPECT_EQ(result.get(), 11);
+}
+
+TEST(JobTest, WorkerPoolStillAcceptsIJob)
+{
+    struct Count : WorkerPool::IJob
+    {
+        std::atomic<int>* n;
+        explicit Count(std::atomic<int>* c) : n(c) {}
+        void execute() override { n->fetch_add(1); }
+    };
+
+    std::atomic<int> n{0};
+    {
+        WorkerPool pool(
+            WorkerPool::Options{.workers = 2, .workStealing = true});
+        for (int i = 0; i < 10; ++i) {
+            pool.addJob(std::make_unique<Count>(&n));
+        }
+        pool.addJob([&pool, &n]() {
+            // spawned from a worker: goes through the recycled deque nodes
+            for (int i = 0; i < 100; ++i) {
+                pool.addJob(std::make_unique<Count>(&n));
+            }
+        });
+    }
+    EXPECT_EQ(n.load(), 110);
+}
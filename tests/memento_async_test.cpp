@@ -0,0 +1,137 @@
+// tests/memento_async_test.cpp
+#include "design_patterns/memento/memento.hpp"
+#include "design_patterns/memento/tlv_adapters.hpp"
+#include "threading/worker_pool.hpp"
+#include <chrono>
+#include <gtest/gtest.h>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+// heavy state held as an immutable shared block: freezing is a refcount bump
+class Simulation : public Memento
+{
+public:
+    std::string tick;
+    std::shared_ptr<const std::vector<int>> world =
+        std::make_shared<const std::vector<int>>(100000, 1);
+    bool failOnSave = false;
+
+    void step(int v)
+    {
+        auto next = std::make_shared<std::vector<int>>(*world);
+        (*next)[0] = v;
+        world = std::move(next);
+        tick = "t" + std::to_string(v);
+    }
+
+private:
+    void _saveToSnapshot(Snapshot& s) const override
+    {
+        if (failOnSave) {
+            throw std::runtime_error("serialization failed");
+        }
+        using namespace tlv_adapt;
+        auto& io = stream(s);
+        io << tick << *world;
+    }
+    void _loadFromSnapshot(Snapshot& s) override
+    {
+        using namespace tlv_adapt;
+        auto& io = stream(s);
+        std::vector<int> w;
+        io >> tick >> w;
+        world = std::make_shared<const std::vector<int>>(std::move(w));
+    }
+
+protected:
+    std::shared_ptr<const Memento> _freeze() const override
+    {
+        return std::make_shared<const Simulation>(*this);
+    }
+};
+
+// no _freeze() override
+class Counter : public Memento
+{
+public:
+    int value = 0;
+    bool failOnSave = false;
+
+private:
+    void _saveToSnapshot(Snapshot& s) const override
+    {
+        if (failOnSave) {
+            throw std::runtime_error("serialization failed");
+        }
+        using namespace tlv_adapt;
+        stream(s) << value;
+    }
+    void _loadFromSnapshot(Snapshot& s) override
+    {
+        using namespace tlv_adapt;
+        stream(s) >> value;
+    }
+};
+
+} // namespace
+
+TEST(MementoAsyncTest, CheckpointIsConsistentWhileCallerKeepsMutating)
+{
+    WorkerPool pool(2);
+    Simulation sim;
+    sim.step(1);
+
+    auto pending = sim.saveAsync(pool);
+    for (int i = 2; i < 50; ++i) {
+        sim.step(i);
+    }
+
+    ASSERT_EQ(pending.wait_for(std::chrono::seconds(5)),
+              std::future_status::ready);
+    Simulation restored;
+    restored.load(pending.get());
+    EXPECT_EQ(restored.tick, "t1");
+    EXPECT_EQ((*restored.world)[0], 1);
+    EXPECT_EQ(restored.world->size(), 100000u);
+    EXPECT_EQ(sim.tick, "t49");
+}
+
+TEST(MementoAsyncTest, SerializationErrorIsDeliveredThroughFuture)
+{
+    WorkerPool pool(1);
+    Simulation sim;
+    sim.failOnSave = true;
+
+    auto pending = sim.saveAsync(pool);
+    EXPECT_THROW(pending.get(), std::runtime_error);
+}
+
+TEST(MementoAsyncTest, WithoutFreezeHookSnapshotIsTakenSynchronously)
+{
+    WorkerPool pool(1);
+    Counter c;
+    c.value = 7;
+
+    auto pending = c.saveAsync(pool);
+    EXPECT_EQ(pending.wait_for(std::chrono::seconds(0)),
+              std::future_status::ready);
+    c.value = 8;
+    c.load(pending.get());
+    EXPECT_EQ(c.value, 7);
+}
+
+TEST(MementoAsyncTest, SynchronousErrorIsDeliveredThroughFuture)
+{
+    WorkerPool pool(1);
+    Counter c;
+    c.failOnSave = true;
+
+    std::future<Memento::Snapshot> pending;
+    EXPECT_NO_THROW(pending = c.saveAsync(pool));
+    EXPECT_THROW(pending.get(), std::runtime_error);
+}
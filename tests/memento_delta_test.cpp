@@ -0,0 +1,170 @@
+// tests/memento_delta_test.cpp
+#include "design_patterns/memento/history.hpp"
+#include "design_patterns/memento/memento.hpp"
+#include "design_patterns/memento/snapdelta.hpp"
+#include "design_patterns/memento/tlv_adapters.hpp"
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+std::vector<std::byte> toBytes(const std::string& s)
+{
+    std::vector<std::byte> out(s.size());
+    for (std::size_t i = 0; i < s.size(); ++i) {
+        out[i] = static_cast<std::byte>(s[i]);
+    }
+    return out;
+}
+
+void expectRoundTrip(const std::vector<std::byte>& base,
+                     const std::vector<std::byte>& target)
+{
+    auto delta = snapdelta::encode(base, target);
+    EXPECT_EQ(snapdelta::apply(base, delta), target);
+}
+
+// large, mostly unchanged state: the editor-style workload delta mode targets
+class Document : public Memento
+{
+public:
+    std::string title;
+    std::vector<std::uint32_t> cells = std::vector<std::uint32_t>(4096, 7);
+
+private:
+    void _saveToSnapshot(Snapshot& s) const override
+    {
+        using namespace tlv_adapt;
+        auto& io = stream(s);
+        io << title << cells;
+    }
+    void _loadFromSnapshot(Snapshot& s) override
+    {
+        using namespace tlv_adapt;
+        auto& io = stream(s);
+        io >> title >> cells;
+    }
+};
+
+} // namespace
+
+TEST(SnapDeltaTest, RoundTripsTypicalEdits)
+{
+    expectRoundTrip(toBytes(""), toBytes(""));
+    expectRoundTrip(toBytes(""), toBytes("hello"));
+    expectRoundTrip(toBytes("hello"), toBytes(""));
+    expectRoundTrip(toBytes("hello world"), toBytes("hello world"));
+    expectRoundTrip(toBytes("hello world"), toBytes("hellO world"));
+    expectRoundTrip(toBytes("abc-0123456789"), toBytes("abcdef-0123456789"));
+    expectRoundTrip(toBytes("abcdef-0123456789"), toBytes("abc-0123456789"));
+    expectRoundTrip(toBytes("0123456789"), toBytes("0123456789abcdef"));
+}
+
+TEST(SnapDeltaTest, RoundTripsRandomMutations)
+{
+    std::mt19937 rng(42);
+    std::vector<std::byte> base(2000);
+    for (auto& b : base) {
+        b = static_cast<std::byte>(rng());
+    }
+    for (int round = 0; round < 50; ++round) {
+        auto target = base;
+        const int edits = static_cast<int>(rng() % 20);
+        for (int e = 0; e < edits; ++e) {
+            target[rng() % target.size()] = static_cast<std::byte>(rng());
+        }
+        target.resize(target.size() + rng() % 64 - 32);
+        expectRoundTrip(base, target);
+        base = target;
+    }
+}
+
+TEST(SnapDeltaTest, SmallEditProducesSmallDelta)
+{
+    std::vector<std::byte> base(10000, std::byte{1});
+    auto target = base;
+    target[5000] = std::byte{2};
+
+    EXPECT_LT(snapdelta::encode(base, target).size(), 16u);
+}
+
+TEST(SnapDeltaTest, CorruptDeltaThrows)
+{
+    auto base = toBytes("hello");
+    std::vector<std::byte> bogus{std::byte{10}, std::byte{0}, std::byte{0}};
+    EXPECT_THROW(snapdelta::apply(base, bogus), std::runtime_error);
+}
+
+TEST(HistoryDeltaTest, UndoRedoMatchesFullMode)
+{
+    Document d;
+    History full;
+    History delta(History::Config{.keyframeInterval = 4});
+
+    for (int i = 0; i < 10; ++i) {
+        d.title = "rev " + std::to_string(i);
+        d.cells[static_cast<std::size_t>(i) * 100] = static_cast<uint32_t>(i);
+        full.push(d.save());
+        delta.push(d.save());
+    }
+
+    Document a;
+    Document b;
+    for (int i = 8; i >= 0; --i) {
+        ASSERT_TRUE(full.undo(a));
+        ASSERT_TRUE(delta.undo(b));
+        EXPECT_EQ(b.title, "rev " + std::to_string(i));
+        EXPECT_EQ(a.title, b.title);
+        EXPECT_EQ(a.cells, b.cells);
+    }
+    EXPECT_FALSE(delta.canUndo());
+    for (int i = 1; i < 10; ++i) {
+        ASSERT_TRUE(delta.redo(b));
+        EXPECT_EQ(b.title, "rev " + std::to_string(i));
+    }
+    EXPECT_FALSE(delta.canRedo());
+}
+
+TEST(HistoryDeltaTest, StoresFarLessThanFullMode)
+{
+    Document d;
+    History full;
+    History delta(History::Config{.keyframeInterval = 32});
+
+    for (int i = 0; i < 32; ++i) {
+        d.cells[static_cast<std::size_t>(i)] = static_cast<uint32_t>(i + 100);
+        full.push(d.save());
+        delta.push(d.save());
+    }
+    EXPECT_EQ(full.size(), delta.size());
+    EXPECT_LT(delta.storedBytes() * 10, full.storedBytes());
+}
+
+TEST(HistoryDeltaTest, PushAfterUndoDeltasAgainstCurrentEntry)
+{
+    Document d;
+    History h(History::Config{.keyframeInterval = 8});
+
+    d.title = "A";
+    h.push(d.save());
+    d.title = "B";
+    h.push(d.save());
+    d.title = "C";
+    h.push(d.save());
+
+    ASSERT_TRUE(h.undo(d));
+    ASSERT_TRUE(h.undo(d));
+    EXPECT_EQ(d.title, "A");
+
+    d.title = "D";
+    h.push(d.save());
+    EXPECT_FALSE(h.canRedo());
+
+    ASSERT_TRUE(h.undo(d));
+    EXPECT_EQ(d.title, "A");
+    ASSERT_TRUE(h.redo(d));
+    EXPECT_EQ(d.title, "D");
+}
@@ -172,3 +172,188 @@ TEST(HistoryTest, RepeatedUndoRedoBoundariesAreSafe)
     EXPECT_EQ(p.name, "Two");
     EXPECT_FALSE(h.canRedo());
 }
+
+TEST(SnapCompressTest, RoundTripsAndShrinksRepetitiveStreams)
+{
+    std::vector<std::byte> raw;
+    for (int i = 0; i < 4000; ++i) {
+        raw.push_back(static_cast<std::byte>(i % 7));
+        raw.push_back(std::byte{0});
+    }
+    auto packed = snapcompress::compress(raw);
+    EXPECT_LT(packed.size() * 10, raw.size());
+    EXPECT_EQ(snapcompress::decompress(packed), raw);
+
+    std::vector<std::byte> empty;
+    EXPECT_EQ(snapcompress::decompress(snapcompress::compress(empty)), empty);
+
+    std::vector<std::byte> tiny{std::byte{1}, std::byte{2}, std::byte{3}};
+    EXPECT_EQ(snapcompress::decompress(snapcompress::compress(tiny)), tiny);
+}
+
+TEST(BoundedHistoryTest, MaxEntriesEvictsOldest)
+{
+    Player p;
+    History h(History::Config{.maxEntries = 3});
+
+    for (int i = 0; i < 10; ++i) {
+        p.name = "P" + std::to_string(i);
+        p.score = static_cast<std::uint64_t>(i);
+        h.push(p.save());
+    }
+    auto s = h.stats();
+    EXPECT_EQ(s.entries, 3u);
+    EXPECT_EQ(s.evictedEntries, 7u);
+
+    ASSERT_TRUE(h.undo(p));
+    ASSERT_TRUE(h.undo(p));
+    EXPECT_EQ(p.name, "P7");
+    EXPECT_FALSE(h.canUndo());
+}
+
+TEST(BoundedHistoryTest, ByteBudgetIsRespectedButCurrentEntryIsKept)
+{
+    Player p;
+    p.name = std::string(100, 'x');
+    const std::size_t one = p.save().size();
+
+    History h(History::Config{.maxBytes = one * 4});
+    for (int i = 0; i < 20; ++i) {
+        p.score = static_cast<std::uint64_t>(i);
+        h.push(p.save());
+        EXPECT_LE(h.storedBytes(), one * 4);
+    }
+    EXPECT_EQ(h.size(), 4u);
+
+    History tiny(History::Config{.maxBytes = 1});
+    tiny.push(p.save());
+    tiny.push(p.save());
+    EXPECT_EQ(tiny.size(), 1u);
+}
+
+TEST(BoundedHistoryTest, EvictionRebasesDeltaEntries)
+{
+    Player p;
+    History h(History::Config{.keyframeInterval = 8, .maxEntries = 3});
+
+    for (int i = 0; i < 12; ++i) {
+        p.name = "delta-" + std::to_string(i);
+        h.push(p.save());
+    }
+    EXPECT_EQ(h.size(), 3u);
+    ASSERT_TRUE(h.undo(p));
+    EXPECT_EQ(p.name, "delta-10");
+    ASSERT_TRUE(h.undo(p));
+    EXPECT_EQ(p.name, "delta-9");
+    ASSERT_TRUE(h.redo(p));
+    ASSERT_TRUE(h.redo(p));
+    EXPECT_EQ(p.name, "delta-11");
+}
+
+TEST(BoundedHistoryTest, InlineCompressionKeepsHotEntriesRaw)
+{
+    Player p;
+    p.name = std::string(2000, 'a');
+    History h(History::Config{.compress = true,
+                              .hotEntries = 2,
+                              .backgroundCompression = false});
+
+    for (int i = 0; i < 6; ++i) {
+        p.score = static_cast<std::uint64_t>(i);
+        h.push(p.save());
+    }
+    auto s = h.stats();
+    EXPECT_EQ(s.entries, 6u);
+    EXPECT_EQ(s.compressedEntries, 4u);
+    EXPECT_LT(s.compressionRatio(), 0.1);
+
+    for (int i = 4; i >= 0; --i) {
+        ASSERT_TRUE(h.undo(p));
+        EXPECT_EQ(p.score, static_cast<std::uint64_t>(i));
+        EXPECT_EQ(p.name.size(), 2000u);
+    }
+}
+
+TEST(BoundedHistoryTest, BackgroundCompressionPacksColdEntries)
+{
+    Player p;
+    p.name = std::string(4000, 'b');
+    History h(History::Config{.compress = true,
+                              .hotEntries = 1,
+                              .backgroundCompression = true});
+
+    for (int i = 0; i < 5; ++i) {
+        p.score = static_cast<std::uint64_t>(i);
+        h.push(p.save());
+    }
+    const std::size_t before = h.storedBytes();
+    h.waitCompression();
+
+    auto s = h.stats();
+    EXPECT_EQ(s.compressedEntries, 4u);
+    EXPECT_LT(s.bytes, before);
+    EXPECT_EQ(s.compressedRawBytes, 4 * p.save().size());
+
+    ASSERT_TRUE(h.undo(p));
+    EXPECT_EQ(p.score, 3u);
+    EXPECT_EQ(p.name, std::string(4000, 'b'));
+}
+
+TEST(BoundedHistoryTest, EvictedEntriesDropTheirBackgroundJobs)
+{
+    Player p;
+    p.name = std::string(4000, 'c');
+    History h(History::Config{.maxEntries = 3,
+                              .compress = true,
+                              .hotEntries = 1,
+                              .backgroundCompression = true});
+
+    for (int i = 0; i < 50; ++i) {
+        p.score = static_cast<std::uint64_t>(i);
+        h.push(p.save());
+    }
+    h.waitCompression();
+
+    auto s = h.stats();
+    EXPECT_EQ(s.entries, 3u);
+    EXPECT_EQ(s.evictedEntries, 47u);
+    EXPECT_EQ(s.compressedEntries, 2u);
+    for (int i = 48; i >= 47; --i) {
+        ASSERT_TRUE(h.undo(p));
+        EXPECT_EQ(p.score, static_cast<std::uint64_t>(i));
+    }
+    EXPECT_FALSE(h.undo(p));
+}
+
+TEST(BoundedHistoryTest, CopiesAreIndependentAndKeepCompressing)
+{
+    Player p;
+    p.name = std::string(4000, 'd');
+    History h(History::Config{.compress = true,
+                              .hotEntries = 1,
+                              .backgroundCompression = true});
+    for (int i = 0; i < 5; ++i) {
+        p.score = static_cast<std::uint64_t>(i);
+        h.push(p.save());
+    }
+
+    History copy(h); // may copy entries the original is still packing
+    h.clear();
+    EXPECT_EQ(copy.size(), 5u);
+
+    p.score = 5;
+    copy.push(p.save());
+    copy.waitCompression();
+    EXPECT_EQ(copy.stats().compressedEntries, 5u);
+    for (int i = 4; i >= 0; --i) {
+        ASSERT_TRUE(copy.undo(p));
+        EXPECT_EQ(p.score, static_cast<std::uint64_t>(i));
+    }
+
+    History assigned;
+    assigned = copy;
+    EXPECT_EQ(assigned.size(), 6u);
+    ASSERT_TRUE(assigned.redo(p));
+    EXPECT_EQ(p.score, 1u);
+    EXPECT_FALSE(h.undo(p));
+}
@@ -123,3 +123,112 @@ TEST(MementoTest, CrossBackend_DataBufferSave_VectorLoad)
     EXPECT_EQ(p_vec.name, "Finn");
     EXPECT_EQ(p_vec.score, 9001u);
 }
+
+// VectorBackend that counts how often its bytes get duplicated
+struct CountingBackend
+{
+    inline static int copies = 0;
+
+    CountingBackend() = default;
+    CountingBackend(const CountingBackend& rhs) : inner(rhs.inner)
+    {
+        ++copies;
+    }
+    CountingBackend(CountingBackend&&) noexcept = default;
+
+    void write(const void* p, size_t n) { inner.write(p, n); }
+    void read(void* p, size_t n) { inner.read(p, n); }
+    size_t tell() const { return inner.tell(); }
+    void seek(size_t pos) { inner.seek(pos); }
+    size_t size() const { return inner.size(); }
+    const std::byte* data() const { return inner.data(); }
+
+    VectorBackend inner;
+};
+
+// same, but without data(): SnapIO cannot read it in place
+struct OpaqueBackend
+{
+    void write(const void* p, size_t n) { inner.write(p, n); }
+    void read(void* p, size_t n) { inner.read(p, n); }
+    size_t tell() const { return inner.tell(); }
+    void seek(size_t pos) { inner.seek(pos); }
+    size_t size() const { return inner.size(); }
+
+    VectorBackend inner;
+};
+
+struct PlayerCounting : Player
+{
+protected:
+    SnapIO createBackend() const override
+    {
+        return SnapIO{CountingBackend{}};
+    }
+};
+
+struct PlayerOpaque : Player
+{
+protected:
+    SnapIO createBackend() const override { return SnapIO{OpaqueBackend{}}; }
+};
+
+// exposes the protected stream() to poke at a snapshot directly
+struct RawAccess : Player
+{
+    static void append(Snapshot& s, std::uint8_t byte)
+    {
+        stream(s).write(&byte, 1);
+    }
+};
+
+TEST(MementoTest, CopyAndLoadDoNotDuplicateSnapshotBytes)
+{
+    PlayerCounting p;
+    p.name = "Gus";
+    p.score = 5;
+
+    CountingBackend::copies = 0;
+    auto snap = p.save();
+    std::vector<Memento::Snapshot> copies(16, snap);
+
+    p.name = "?";
+    p.load(copies.back());
+    p.load(snap);
+
+    EXPECT_EQ(p.name, "Gus");
+    EXPECT_EQ(p.score, 5u);
+    EXPECT_EQ(CountingBackend::copies, 0);
+}
+
+TEST(MementoTest, WritingToASharedSnapshotDetachesIt)
+{
+    Player p;
+    p.name = "Hana";
+    p.score = 1;
+
+    auto snap = p.save();
+    auto copy = snap;
+    RawAccess::append(copy, 0xFF);
+
+    EXPECT_EQ(copy.size(), snap.size() + 1);
+    p.name = "";
+    p.load(snap);
+    EXPECT_EQ(p.name, "Hana");
+}
+
+TEST(MementoTest, NonContiguousBackend_FallsBackToPrivateCopy)
+{
+    PlayerOpaque p;
+    p.name = "Ivo";
+    p.score = 12;
+
+    auto snap = p.save();
+    p.name = "";
+    p.load(snap);
+    p.load(snap);
+
+    EXPECT_EQ(p.name, "Ivo");
+    EXPECT_EQ(p.score, 12u);
+    EXPECT_EQ(snap.bytes().size(), snap.size());
+}
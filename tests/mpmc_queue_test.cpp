@@ -0,0 +1,202 @@
+// tests/mpmc_queue_test.cpp
+#include "threading/mpmc_queue.hpp"
+#include "threading/worker_pool.hpp"
+#include <atomic>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(MPMCQueueTest, CapacityRoundsUpToPowerOfTwo)
+{
+    MPMCQueue<int> q(5);
+    EXPECT_EQ(q.capacity(), 8u);
+    EXPECT_THROW(MPMCQueue<int>(0), std::invalid_argument);
+}
+
+TEST(MPMCQueueTest, FifoUntilFullThenRejects)
+{
+    MPMCQueue<int> q(4);
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(q.try_push(i));
+    }
+    EXPECT_FALSE(q.try_push(99));
+    EXPECT_EQ(q.size_approx(), 4u);
+
+    for (int i = 0; i < 4; ++i) {
+        auto v = q.try_pop();
+        ASSERT_TRUE(v.has_value());
+        EXPECT_EQ(*v, i);
+    }
+    EXPECT_FALSE(q.try_pop().has_value());
+
+    // the ring wraps around to the next lap
+    EXPECT_TRUE(q.try_emplace(7));
+    EXPECT_EQ(q.try_pop(), 7);
+}
+
+TEST(MPMCQueueTest, MovesElementsAndDestroysLeftovers)
+{
+    auto tracked = std::make_shared<int>(1);
+    {
+        MPMCQueue<std::shared_ptr<int>> q(2);
+        EXPECT_TRUE(q.try_push(tracked));
+        auto moved = std::make_shared<int>(2);
+        EXPECT_TRUE(q.try_push(std::move(moved)));
+        EXPECT_EQ(moved, nullptr);
+
+        auto rejected = std::make_shared<int>(3);
+        EXPECT_FALSE(q.try_push(std::move(rejected)));
+        EXPECT_NE(rejected, nullptr) << "failed push must not consume";
+        EXPECT_EQ(tracked.use_count(), 2);
+    }
+    EXPECT_EQ(tracked.use_count(), 1);
+}
+
+TEST(MPMCQueueTest, ConcurrentProducersAndConsumersSeeEveryElementOnce)
+{
+    const int producers = 3;
+    const int consumers = 3;
+    const int perProducer = 4000;
+    MPMCQueue<int> q(64);
+    std::atomic<long long> sum{0};
+    std::atomic<int> popped{0};
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p]() {
+            for (int i = 0; i < perProducer; ++i) {
+                while (!q.try_push(p * perProducer + i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (int c = 0; c < consumers; ++c) {
+        threads.emplace_back([&]() {
+            while (popped.load() < producers * perProducer) {
+                if (auto v = q.try_pop()) {
+                    sum.fetch_add(*v);
+                    popped.fetch_add(1);
+                }
+                else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    const long long n = static_cast<long long>(producers) * perProducer;
+    EXPECT_EQ(popped.load(), n);
+    EXPECT_EQ(sum.load(), n * (n - 1) / 2);
+}
+
+TEST(BlockingMPMCQueueTest, PopParksUntilPushAndCloseReleasesIt)
+{
+    BlockingMPMCQueue<int> q(4);
+    std::atomic<bool> got{false};
+
+    std::thread consumer([&]() {
+        auto v = q.pop();
+        EXPECT_EQ(v, 42);
+        got = true;
+        EXPECT_FALSE(q.pop().has_value());
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_FALSE(got.load());
+    q.push(42);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    q.close();
+    consumer.join();
+    EXPECT_TRUE(got.load());
+    EXPECT_THROW(q.push(1), std::runtime_error);
+}
+
+TEST(BlockingMPMCQueueTest, PushParksWhileFull)
+{
+    BlockingMPMCQueue<int> q(2);
+    q.push(1);
+    q.push(2);
+    EXPECT_FALSE(q.try_push(3));
+
+    std::atomic<bool> pushed{false};
+    std::thread producer([&]() {
+        q.push(3);
+        pushed = true;
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_FALSE(pushed.load());
+    EXPECT_EQ(q.pop(), 1);
+    producer.join();
+    EXPECT_TRUE(pushed.load());
+    EXPECT_EQ(q.pop(), 2);
+    EXPECT_EQ(q.pop(), 3);
+}
+
+TEST(BlockingMPMCQueueTest, CloseDrainsRemainingElements)
+{
+    BlockingMPMCQueue<std::string> q(8);
+    q.push("a");
+    q.push("b");
+    q.close();
+    EXPECT_EQ(q.pop(), "a");
+    EXPECT_EQ(q.pop(), "b");
+    EXPECT_FALSE(q.pop().has_value());
+}
+
+TEST(BlockingMPMCQueueTest, PushRacingCloseIsEitherRejectedOrPopped)
+{
+    for (int round = 0; round < 50; ++round) {
+        BlockingMPMCQueue<int> q(64);
+        std::atomic<int> accepted{0};
+        std::atomic<int> popped{0};
+
+        std::vector<std::thread> threads;
+        for (int p = 0; p < 2; ++p) {
+            threads.emplace_back([&]() {
+                try {
+                    for (;;) {
+                        q.push(1);
+                        accepted.fetch_add(1);
+                    }
+                }
+                catch (const std::runtime_error&) {
+                }
+            });
+        }
+        for (int c = 0; c < 2; ++c) {
+            threads.emplace_back([&]() {
+                while (q.pop()) {
+                    popped.fetch_add(1);
+                }
+            });
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        q.close();
+        for (auto& t : threads) {
+            t.join();
+        }
+        ASSERT_EQ(popped.load(), accepted.load()) << "round " << round;
+    }
+}
+
+TEST(WorkerPoolBoundedQueueTest, RunsEveryJobWithBackPressure)
+{
+    std::atomic<int> counter{0};
+    {
+        WorkerPool pool(WorkerPool::Options{.workers = 4, .queueCapacity = 8});
+        for (int i = 0; i < 5000; ++i) {
+            pool.addJob([&]() {
+                counter.fetch_add(1, std::memory_order_relaxed);
+            });
+        }
+    }
+    EXPECT_EQ(counter.load(), 5000);
+}
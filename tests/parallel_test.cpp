@@ -0,0 +1,165 @@
+// tests/parallel_test.cpp
+#include "threading/parallel.hpp"
+#include "threading/worker_pool.hpp"
+#include <atomic>
+#include <functional>
+#include <gtest/gtest.h>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(ParallelForTest, VisitsEveryIndexExactlyOnce)
+{
+    WorkerPool pool(4);
+    std::vector<std::atomic<int>> hits(10007);
+
+    parallel_for(pool, 0, hits.size(), 64, [&](size_t i) {
+        hits[i].fetch_add(1);
+    });
+    for (size_t i = 0; i < hits.size(); ++i) {
+        ASSERT_EQ(hits[i].load(), 1) << i;
+    }
+
+    // empty range and automatic grain
+    parallel_for(pool, 5, 5, 0, [&](size_t) {
+        FAIL();
+    });
+    parallel_for(pool, 0, 100, 0, [&](size_t i) {
+        hits[i].fetch_add(1);
+    });
+    EXPECT_EQ(hits[99].load(), 2);
+}
+
+TEST(ParallelForTest, RangeOverloadWritesElements)
+{
+    WorkerPool pool(WorkerPool::Options{.workers = 3, .workStealing = true});
+    std::vector<int> values(1000, 1);
+    parallel_for(pool, values, 16, [](int& v) {
+        v *= 3;
+    });
+    EXPECT_EQ(std::accumulate(values.begin(), values.end(), 0), 3000);
+}
+
+TEST(ParallelForTest, NestedLoopsInsideJobsDoNotDeadlock)
+{
+    WorkerPool pool(WorkerPool::Options{.workers = 2, .workStealing = true});
+    std::atomic<int> cells{0};
+    // more outer iterations than workers: every worker blocks in an inner
+    // loop and has to help instead of waiting
+    parallel_for(pool, 0, 8, 1, [&](size_t) {
+        parallel_for(pool, 0, 100, 10, [&](size_t) {
+            cells.fetch_add(1);
+        });
+    });
+    EXPECT_EQ(cells.load(), 800);
+}
+
+TEST(ParallelForTest, FirstExceptionReachesCaller)
+{
+    WorkerPool pool(2);
+    std::atomic<int> ran{0};
+    EXPECT_THROW(parallel_for(pool,
+                              0,
+                              1000,
+                              10,
+                              [&](size_t i) {
+                                  ran.fetch_add(1);
+                                  if (i == 500) {
+                                      throw std::runtime_error("bad cell");
+                                  }
+                              }),
+                 std::runtime_error);
+    EXPECT_LE(ran.load(), 1000);
+
+    // the pool is still usable afterwards
+    parallel_for(pool, 0, 10, 1, [&](size_t) {
+        ran.fetch_add(1);
+    });
+}
+
+TEST(ParallelForTest, PoolStoppedMidwayReportsTheSubmitError)
+{
+    WorkerPool pool(2);
+    std::atomic<bool> stopped{false};
+    // the caller runs chunk 0 once it has queued the other halves; workers
+    // hold their first chunk until then, so queued halves split afterwards
+    // and find the pool closed
+    EXPECT_THROW(parallel_for(pool,
+                              0,
+                              64,
+                              1,
+                              [&](size_t i) {
+                                  if (i == 0) {
+                                      stopped = true;
+                                      pool.stop();
+                                  }
+                                  while (!stopped.load()) {
+                                      std::this_thread::yield();
+                                  }
+                              }),
+                 std::runtime_error);
+}
+
+TEST(ParallelReduceTest, SumsSquares)
+{
+    WorkerPool pool(WorkerPool::Options{.workers = 4, .workStealing = true});
+    const long n = 100000;
+    long sum = parallel_reduce(
+        pool,
+        0,
+        static_cast<size_t>(n),
+        10L,
+        [](size_t i) {
+            return static_cast<long>(i % 7);
+        },
+        std::plus<>{});
+
+    long expected = 10;
+    for (long i = 0; i < n; ++i) {
+        expected += i % 7;
+    }
+    EXPECT_EQ(sum, expected);
+}
+
+TEST(ParallelReduceTest, NonCommutativeCombineKeepsIndexOrder)
+{
+    WorkerPool pool(4);
+    std::vector<std::string> words;
+    for (int i = 0; i < 300; ++i) {
+        words.push_back(std::to_string(i % 10));
+    }
+    std::string joined = parallel_reduce(
+        pool,
+        words,
+        std::string(">"),
+        [](const std::string& w) {
+            return w;
+        },
+        [](std::string a, const std::string& b) {
+            return a + b;
+        },
+        7);
+
+    std::string expected = ">";
+    for (const auto& w : words) {
+        expected += w;
+    }
+    EXPECT_EQ(joined, expected);
+}
+
+TEST(ParallelReduceTest, EmptyRangeReturnsInit)
+{
+    WorkerPool pool(1);
+    std::vector<int> none;
+    EXPECT_EQ(parallel_reduce(
+                  pool,
+                  none,
+                  42,
+                  [](int v) {
+                      return v;
+                  },
+                  std::plus<>{}),
+              42);
+}
@@ -0,0 +1,112 @@
+// tests/pool_metrics_test.cpp
+#include "threading/pool_metrics.hpp"
+#include "threading/worker_pool.hpp"
+#include <atomic>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+TEST(LatencyHistogramTest, BucketsByPowerOfTwo)
+{
+    LatencyHistogram h;
+    LatencyHistogram::Snapshot empty;
+    h.addTo(empty);
+    EXPECT_EQ(empty.count(), 0u);
+    EXPECT_EQ(empty.percentile(0.5), 0ns);
+
+    for (int i = 0; i < 90; ++i) {
+        h.record(100ns); // bucket [64, 128)
+    }
+    for (int i = 0; i < 10; ++i) {
+        h.record(1ms);
+    }
+    h.record(-5ns); // clock skew counts as 0
+
+    LatencyHistogram::Snapshot s;
+    h.addTo(s);
+    EXPECT_EQ(s.count(), 101u);
+    EXPECT_EQ(s.percentile(0.5), 128ns);
+    EXPECT_GE(s.percentile(0.99), 1ms);
+    EXPECT_LT(s.percentile(0.99), 2ms);
+    EXPECT_EQ(s.percentile(1.0), s.percentile(0.99));
+
+    LatencyHistogram::Snapshot twice = s;
+    twice.merge(s);
+    EXPECT_EQ(twice.count(), 202u);
+}
+
+TEST(PoolMetricsTest, RecordsWaitRunAndUtilization)
+{
+    WorkerPool pool(WorkerPool::Options{.workers = 2, .metrics = true});
+    for (int i = 0; i < 20; ++i) {
+        pool.addJob([]() {
+            std::this_thread::sleep_for(1ms);
+        });
+    }
+    pool.waitIdle();
+
+    PoolMetrics m = pool.metrics();
+    EXPECT_EQ(m.runTime.count(), 20u);
+    EXPECT_EQ(m.queueLatency.count(), 20u);
+    EXPECT_GE(m.runTime.percentile(0.5), 1ms);
+    EXPECT_EQ(m.pending, 0u);
+    EXPECT_EQ(m.queueDepth, 0u);
+
+    ASSERT_EQ(m.workers.size(), 2u);
+    std::uint64_t jobs = 0;
+    std::chrono::nanoseconds busy{0};
+    for (const auto& w : m.workers) {
+        EXPECT_TRUE(w.live);
+        jobs += w.jobs;
+        busy += w.busy;
+    }
+    EXPECT_EQ(jobs, 20u);
+    EXPECT_GE(busy, 20ms);
+    EXPECT_EQ(m.helperJobs, 0u);
+}
+
+TEST(PoolMetricsTest, SeesQueueDepthAndHelpers)
+{
+    WorkerPool pool(WorkerPool::Options{.workers = 1, .metrics = true});
+    std::atomic<bool> started{false};
+    std::atomic<bool> release{false};
+    pool.addJob([&]() {
+        started.store(true);
+        while (!release.load()) {
+            std::this_thread::yield();
+        }
+    });
+    while (!started.load()) {
+        std::this_thread::yield();
+    }
+    for (int i = 0; i < 5; ++i) {
+        pool.addJob([]() {
+        });
+    }
+    PoolMetrics m = pool.metrics();
+    EXPECT_EQ(m.queueDepth, 5u);
+    EXPECT_EQ(m.pending, 6u);
+
+    // this thread helps with one of them
+    EXPECT_TRUE(pool.runOneJob());
+    release.store(true);
+    pool.waitIdle();
+    m = pool.metrics();
+    EXPECT_EQ(m.helperJobs, 1u);
+    EXPECT_EQ(m.runTime.count(), 6u);
+}
+
+TEST(PoolMetricsTest, DisabledMetricsStillReportDepth)
+{
+    WorkerPool pool(2);
+    pool.addJob([]() {
+    });
+    pool.waitIdle();
+    PoolMetrics m = pool.metrics();
+    EXPECT_EQ(m.runTime.count(), 0u);
+    EXPECT_EQ(m.workers.size(), 2u);
+    EXPECT_EQ(m.workers[0].jobs, 0u);
+    EXPECT_EQ(m.pending, 0u);
+}
@@ -0,0 +1,143 @@
+// tests/snapio_file_test.cpp
+#include "design_patterns/memento/memento.hpp"
+#include "design_patterns/memento/snapio_file.hpp"
+#include "design_patterns/memento/tlv_adapters.hpp"
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+
+std::string tempPath(const std::string& tag)
+{
+    auto dir = std::filesystem::temp_directory_path();
+    return (dir
+            / ("libftpp_" + tag + "_" + std::to_string(::getpid()) + ".snap"))
+        .string();
+}
+
+// removes the snapshot file when the test ends
+struct TempFile
+{
+    std::string path;
+    explicit TempFile(const std::string& tag) : path(tempPath(tag)) {}
+    ~TempFile() { std::filesystem::remove(path); }
+};
+
+class World : public Memento
+{
+public:
+    std::string label;
+    std::vector<std::uint64_t> cells;
+    std::string checkpoint;
+
+private:
+    void _saveToSnapshot(Snapshot& s) const override
+    {
+        using namespace tlv_adapt;
+        auto& io = stream(s);
+        io << label << cells;
+    }
+    void _loadFromSnapshot(Snapshot& s) override
+    {
+        using namespace tlv_adapt;
+        auto& io = stream(s);
+        io >> label >> cells;
+    }
+
+protected:
+    SnapIO createBackend() const override
+    {
+        if (checkpoint.empty()) {
+            return VectorBackend{};
+        }
+        return SnapIO{FileBackend(checkpoint)};
+    }
+};
+
+} // namespace
+
+TEST(SnapIOFileTest, SaveStreamsToDiskAndMmapRestores)
+{
+    TempFile file("mmap");
+    World w;
+    w.checkpoint = file.path;
+    w.label = "tick-42";
+    for (std::uint64_t i = 0; i < 100000; ++i) {
+        w.cells.push_back(i * 3);
+    }
+
+    auto snap = w.save();
+    EXPECT_EQ(std::filesystem::file_size(file.path), snap.size());
+
+    World restored;
+    restored.load(Memento::Snapshot(MmapBackend(file.path)));
+    EXPECT_EQ(restored.label, "tick-42");
+    EXPECT_EQ(restored.cells, w.cells);
+}
+
+TEST(SnapIOFileTest, FileBackendSnapshotLoadsDirectly)
+{
+    TempFile file("direct");
+    World w;
+    w.checkpoint = file.path;
+    w.label = "direct";
+    w.cells = {1, 2, 3};
+
+    auto snap = w.save();
+    w.label.clear();
+    w.cells.clear();
+
+    // loads twice through the shared file with independent cursors
+    w.load(snap);
+    w.load(snap);
+    EXPECT_EQ(w.label, "direct");
+    EXPECT_EQ(w.cells, (std::vector<std::uint64_t>{1, 2, 3}));
+}
+
+TEST(SnapIOFileTest, FileBackendHandlesWritesAcrossBufferBoundaries)
+{
+    TempFile file("boundary");
+    FileBackend fb(file.path);
+    std::vector<std::byte> big(FileBackend::kBufferSize + 17, std::byte{7});
+    const std::byte tag{1};
+
+    fb.write(&tag, 1);
+    fb.write(big.data(), big.size());
+    fb.write(&tag, 1);
+    EXPECT_EQ(fb.size(), big.size() + 2);
+
+    std::byte b{};
+    fb.read(&b, 1);
+    EXPECT_EQ(b, tag);
+    std::vector<std::byte> back(big.size());
+    fb.read(back.data(), back.size());
+    EXPECT_EQ(back, big);
+    fb.read(&b, 1);
+    EXPECT_EQ(b, tag);
+    EXPECT_THROW(fb.read(&b, 1), std::out_of_range);
+
+    fb.flush();
+    EXPECT_EQ(std::filesystem::file_size(file.path), big.size() + 2);
+}
+
+TEST(SnapIOFileTest, MmapBackendIsReadOnlyAndChecksBounds)
+{
+    TempFile file("ro");
+    {
+        FileBackend fb(file.path);
+        const char msg[] = "abcd";
+        fb.write(msg, 4);
+    }
+    MmapBackend mb(file.path);
+    EXPECT_EQ(mb.size(), 4u);
+    char out[4];
+    mb.read(out, 4);
+    EXPECT_EQ(std::string(out, 4), "abcd");
+    EXPECT_THROW(mb.read(out, 1), std::out_of_range);
+    EXPECT_THROW(mb.write(out, 1), std::logic_error);
+    EXPECT_THROW(MmapBackend(file.path + ".missing"), std::runtime_error);
+}
@@ -0,0 +1,159 @@
+// tests/snapio_test.cpp
+#include "design_patterns/memento/snapio.hpp"
+#include "design_patterns/memento/tlv_adapters.hpp"
+#include <cstring>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+struct CallCounts
+{
+    int writes{0};
+    int reads{0};
+};
+
+// VectorBackend recording how often SnapIO crosses into it
+template <bool Contiguous> struct CountingBackend
+{
+    CallCounts* calls;
+
+    void write(const void* p, size_t n)
+    {
+        ++calls->writes;
+        inner.write(p, n);
+    }
+    void read(void* p, size_t n)
+    {
+        ++calls->reads;
+        inner.read(p, n);
+    }
+    size_t tell() const { return inner.tell(); }
+    void seek(size_t pos) { inner.seek(pos); }
+    size_t size() const { return inner.size(); }
+    const std::byte* data() const
+        requires Contiguous
+    {
+        return inner.data();
+    }
+
+    VectorBackend inner;
+};
+
+} // namespace
+
+TEST(SnapIOTest, SmallTlvWritesAreBatchedIntoFewBackendCalls)
+{
+    using namespace tlv_adapt;
+    CallCounts calls;
+    SnapIO io{CountingBackend<true>{&calls, {}}};
+
+    for (std::uint32_t i = 0; i < 1000; ++i) {
+        io << i;
+    }
+    io.flush();
+
+    // one call per kStageSize bytes instead of two or three per field
+    EXPECT_LE(calls.writes, static_cast<int>(io.size() / 200 + 1));
+
+    io.seek(0);
+    for (std::uint32_t i = 0; i < 1000; ++i) {
+        std::uint32_t v = 0;
+        io >> v;
+        ASSERT_EQ(v, i);
+    }
+    EXPECT_EQ(calls.reads, 0);
+    EXPECT_EQ(io.tell(), io.size());
+}
+
+TEST(SnapIOTest, NonContiguousBackendStillReadsThroughBackend)
+{
+    using namespace tlv_adapt;
+    CallCounts calls;
+    SnapIO io{CountingBackend<false>{&calls, {}}};
+
+    io << std::string("abc") << std::uint64_t{77};
+    io.seek(0);
+
+    std::string s;
+    std::uint64_t v = 0;
+    io >> s >> v;
+    EXPECT_EQ(s, "abc");
+    EXPECT_EQ(v, 77u);
+    EXPECT_GT(calls.reads, 0);
+}
+
+TEST(SnapIOTest, ObservationsSeeStagedBytes)
+{
+    SnapIO io{VectorBackend{}};
+    const char msg[] = "hello";
+
+    io.write(msg, 5);
+    EXPECT_EQ(io.size(), 5u);
+    EXPECT_EQ(io.tell(), 0u);
+    // const accessors do not settle: no view while bytes are staged
+    EXPECT_FALSE(io.contiguous().has_value());
+
+    SnapIO copy = io;
+    io.write(msg, 5);
+    EXPECT_EQ(copy.size(), 5u);
+    EXPECT_EQ(io.size(), 10u);
+
+    io.flush();
+    ASSERT_TRUE(io.contiguous().has_value());
+    EXPECT_EQ(io.contiguous()->size(), 10u);
+    char back[5];
+    copy.read(back, 5);
+    EXPECT_EQ(std::memcmp(back, msg, 5), 0);
+}
+
+TEST(SnapIOTest, LargeWritesAndInterleavedReadsKeepOrder)
+{
+    SnapIO io{VectorBackend{}};
+    std::vector<std::byte> big(SnapIO::kStageSize * 3, std::byte{0xAB});
+    const std::byte tag{0x01};
+
+    io.write(&tag, 1);
+    io.write(big.data(), big.size());
+    io.write(&tag, 1);
+
+    std::byte first{};
+    io.read(&first, 1);
+    EXPECT_EQ(first, tag);
+    EXPECT_EQ(io.tell(), 1u);
+
+    // write after a windowed read: cursor is synced, bytes land at the end
+    io.write(&tag, 1);
+    EXPECT_EQ(io.size(), big.size() + 3);
+
+    std::vector<std::byte> back(big.size());
+    io.read(back.data(), back.size());
+    EXPECT_EQ(back, big);
+    EXPECT_EQ(io.tell(), big.size() + 1);
+}
+
+TEST(SnapIOTest, ReadPastEndThrowsBackendError)
+{
+    SnapIO io{VectorBackend{}};
+    std::byte b{};
+    io.write(&b, 1);
+    io.read(&b, 1);
+    EXPECT_THROW(io.read(&b, 1), std::out_of_range);
+}
+
+TEST(SnapIOTest, MovedSnapIOKeepsStagedBytes)
+{
+    SnapIO io{VectorBackend{}};
+    const char msg[] = "abc";
+    io.write(msg, 3);
+
+    SnapIO moved = std::move(io);
+    EXPECT_EQ(moved.size(), 3u);
+
+    SnapIO other{VectorBackend{}};
+    other.write(msg, 1);
+    other = std::move(moved);
+    EXPECT_EQ(other.size(), 3u);
+}
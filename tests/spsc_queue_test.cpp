@@ -0,0 +1,134 @@
+// tests/spsc_queue_test.cpp
+#include "threading/spsc_queue.hpp"
+#include <atomic>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <thread>
+
+TEST(SPSCQueueTest, FifoUntilFullThenRejects)
+{
+    SPSCQueue<int> q(3);
+    EXPECT_EQ(q.capacity(), 4u);
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(q.try_push(i));
+    }
+    EXPECT_FALSE(q.try_push(4));
+    EXPECT_EQ(q.size_approx(), 4u);
+
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_EQ(q.try_pop(), i);
+    }
+    EXPECT_FALSE(q.try_pop().has_value());
+    EXPECT_THROW(SPSCQueue<int>(0), std::invalid_argument);
+}
+
+TEST(SPSCQueueTest, StagedElementsAppearOnPublish)
+{
+    SPSCQueue<std::string> q(8);
+    EXPECT_TRUE(q.try_stage(std::string("a")));
+    EXPECT_TRUE(q.try_stage(std::string("b")));
+    EXPECT_FALSE(q.try_pop().has_value());
+    EXPECT_EQ(q.size_approx(), 0u);
+
+    q.publish();
+    EXPECT_EQ(q.size_approx(), 2u);
+    EXPECT_EQ(q.try_pop(), "a");
+    EXPECT_EQ(q.try_pop(), "b");
+}
+
+TEST(SPSCQueueTest, DestroysUnconsumedAndStagedElements)
+{
+    auto tracked = std::make_shared<int>(0);
+    {
+        SPSCQueue<std::shared_ptr<int>> q(4);
+        q.try_push(tracked);
+        q.try_stage(tracked);
+        EXPECT_EQ(tracked.use_count(), 3);
+    }
+    EXPECT_EQ(tracked.use_count(), 1);
+}
+
+TEST(SPSCQueueTest, CloseDrainsThenReportsEnd)
+{
+    SPSCQueue<int> q(4);
+    q.push(1);
+    q.push(2);
+    q.close();
+    EXPECT_TRUE(q.closed());
+    EXPECT_THROW(q.push(3), std::runtime_error);
+    EXPECT_THROW(q.try_push(3), std::runtime_error);
+    EXPECT_EQ(q.pop(), 1);
+    EXPECT_EQ(q.pop(), 2);
+    EXPECT_FALSE(q.pop().has_value());
+}
+
+TEST(SPSCQueueTest, BlockedPopWakesOnClose)
+{
+    SPSCQueue<int> q(4);
+    std::atomic<bool> done{false};
+    std::thread consumer([&]() {
+        EXPECT_FALSE(q.pop().has_value());
+        done = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_FALSE(done.load());
+    q.close();
+    consumer.join();
+    EXPECT_TRUE(done.load());
+}
+
+TEST(SPSCQueueTest, TransfersInOrderBetweenTwoThreads)
+{
+    const int n = 200000;
+    SPSCQueue<int> q(256);
+
+    std::thread producer([&]() {
+        for (int i = 0; i < n; ++i) {
+            if (i % 16 == 15) {
+                // batched publish path
+                while (!q.try_stage(i)) {
+                    q.publish();
+                    std::this_thread::yield();
+                }
+                q.publish();
+            }
+            else {
+                q.push(i);
+            }
+        }
+        q.close();
+    });
+
+    int expected = 0;
+    while (auto v = q.pop()) {
+        ASSERT_EQ(*v, expected);
+        ++expected;
+    }
+    producer.join();
+    EXPECT_EQ(expected, n);
+}
+
+TEST(SPSCQueueTest, PingPongWakesParkedSidesPromptly)
+{
+    // every round trip empties both rings, so each side keeps parking and
+    // relies on the other's wake-up; a lost one would stall the exchange
+    const int rounds = 2000;
+    SPSCQueue<int> ping(1);
+    SPSCQueue<int> pong(1);
+
+    std::thread echo([&]() {
+        while (auto v = ping.pop()) {
+            pong.push(*v + 1);
+        }
+    });
+    const auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; ++i) {
+        ping.push(i);
+        ASSERT_EQ(pong.pop(), i + 1);
+    }
+    ping.close();
+    echo.join();
+    EXPECT_LT(std::chrono::steady_clock::now() - t0, std::chrono::seconds(5));
+}
@@ -0,0 +1,190 @@
+// tests/task_graph_test.cpp
+#include "threading/task_graph.hpp"
+#include "threading/worker_pool.hpp"
+#include <atomic>
+#include <gtest/gtest.h>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+TEST(TaskGraphTest, RunsTasksAfterTheirPredecessors)
+{
+    WorkerPool pool(WorkerPool::Options{.workers = 3, .workStealing = true});
+    std::mutex lock;
+    std::vector<int> order;
+    auto log = [&](int v) {
+        return [&order, &lock, v]() {
+            std::lock_guard<std::mutex> guard(lock);
+            order.push_back(v);
+        };
+    };
+
+    // 0 -> {1, 2} -> 3
+    TaskGraph graph;
+    auto a = graph.add(log(0));
+    auto b = graph.add(log(1), {a});
+    auto c = graph.add(log(2), {a});
+    graph.add(log(3), {b, c});
+    EXPECT_EQ(graph.size(), 4u);
+
+    graph.run(pool);
+    ASSERT_EQ(order.size(), 4u);
+    EXPECT_EQ(order.front(), 0);
+    EXPECT_EQ(order.back(), 3);
+}
+
+TEST(TaskGraphTest, ReusedAcrossRuns)
+{
+    WorkerPool pool(2);
+    std::atomic<int> counter{0};
+    std::vector<int> seenByLast;
+
+    // a chain plus a wide fan-in
+    TaskGraph graph;
+    auto head = graph.add([&]() {
+        counter.fetch_add(1);
+    });
+    std::vector<TaskGraph::TaskId> middle;
+    for (int i = 0; i < 16; ++i) {
+        middle.push_back(graph.add(
+            [&]() {
+                counter.fetch_add(1);
+            },
+            {head}));
+    }
+    auto tail = graph.add([&]() {
+        seenByLast.push_back(counter.load());
+    });
+    for (auto id : middle) {
+        graph.precede(id, tail);
+    }
+
+    for (int frame = 1; frame <= 50; ++frame) {
+        graph.run(pool);
+        ASSERT_EQ(counter.load(), frame * 17);
+    }
+    ASSERT_EQ(seenByLast.size(), 50u);
+    EXPECT_EQ(seenByLast.back(), 50 * 17);
+}
+
+TEST(TaskGraphTest, FailureSkipsDependentsAndRethrows)
+{
+    WorkerPool pool(2);
+    std::atomic<int> ran{0};
+    bool shouldThrow = true;
+
+    TaskGraph graph;
+    auto bad = graph.add([&]() {
+        if (shouldThrow) {
+            throw std::runtime_error("broken");
+        }
+    });
+    auto dependent = graph.add(
+        [&]() {
+            ran.fetch_add(1);
+        },
+        {bad});
+    graph.add(
+        [&]() {
+            ran.fetch_add(1);
+        },
+        {dependent});
+    graph.add([&]() {
+        ran.fetch_add(10); // independent branch still runs
+    });
+
+    EXPECT_THROW(graph.run(pool), std::runtime_error);
+    EXPECT_EQ(ran.load(), 10);
+
+    // the next run starts clean
+    shouldThrow = false;
+    graph.run(pool);
+    EXPECT_EQ(ran.load(), 22);
+}
+
+TEST(TaskGraphTest, StoppedPoolSkipsTasksAndKeepsTheGraphReusable)
+{
+    WorkerPool pool(2);
+    pool.stop();
+    std::atomic<int> ran{0};
+
+    TaskGraph graph;
+    auto a = graph.add([&]() {
+        ran.fetch_add(1);
+    });
+    graph.add(
+        [&]() {
+            ran.fetch_add(1);
+        },
+        {a});
+    graph.add([&]() {
+        ran.fetch_add(1);
+    });
+
+    EXPECT_THROW(graph.run(pool), std::runtime_error);
+    // not left marked as running
+    EXPECT_THROW(graph.run(pool), std::runtime_error);
+    EXPECT_EQ(ran.load(), 0);
+
+    WorkerPool live(2);
+    graph.run(live);
+    EXPECT_EQ(ran.load(), 3);
+}
+
+TEST(TaskGraphTest, SuccessorRefusedMidRunIsSkipped)
+{
+    WorkerPool pool(2);
+    std::atomic<int> ran{0};
+    std::thread stopper;
+
+    TaskGraph graph;
+    auto root = graph.add([&]() {
+        // stop the pool from outside and wait until it refuses jobs; it
+        // joins this worker only after we return
+        stopper = std::thread([&pool]() {
+            pool.stop();
+        });
+        try {
+            for (;;) {
+                pool.addJob([]() {
+                });
+                std::this_thread::yield();
+            }
+        }
+        catch (const std::runtime_error&) {
+        }
+    });
+    // two released at once: one runs inline, the other is pushed
+    for (int i = 0; i < 2; ++i) {
+        graph.add(
+            [&]() {
+                ran.fetch_add(1);
+            },
+            {root});
+    }
+
+    EXPECT_THROW(graph.run(pool), std::runtime_error);
+    stopper.join();
+    EXPECT_EQ(ran.load(), 1);
+}
+
+TEST(TaskGraphTest, RejectsInvalidEdges)
+{
+    WorkerPool pool(1);
+    TaskGraph graph;
+    auto a = graph.add([]() {
+    });
+    auto b = graph.add(
+        []() {
+        },
+        {a});
+    EXPECT_THROW(graph.precede(a, 7), std::out_of_range);
+    EXPECT_THROW(graph.precede(a, a), std::logic_error);
+
+    graph.precede(b, a);
+    EXPECT_THROW(graph.run(pool), std::logic_error);
+
+    TaskGraph empty;
+    empty.run(pool);
+}
@@ -0,0 +1,255 @@
+#include "network/impl/reactor/epoll_reactor.hpp"
+#include "threading/task.hpp"
+#include <atomic>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+
+Task<int> answer()
+{
+    co_return 42;
+}
+
+Task<long long> sum(int depth)
+{
+    if (depth == 0) {
+        co_return 0;
+    }
+    co_return depth + co_await sum(depth - 1);
+}
+
+Task<> fail()
+{
+    throw std::runtime_error("boom");
+    co_return;
+}
+
+struct Pipe
+{
+    int fds[2];
+
+    Pipe() { EXPECT_EQ(::pipe(fds), 0); }
+    ~Pipe()
+    {
+        ::close(fds[0]);
+        ::close(fds[1]);
+    }
+};
+
+} // namespace
+
+TEST(TaskTest, IsLazyAndReturnsItsValue)
+{
+    bool started = false;
+    auto make = [&]() -> Task<int> {
+        started = true;
+        co_return co_await answer() + 1;
+    };
+    Task<int> t = make();
+    EXPECT_FALSE(started);
+    EXPECT_EQ(syncWait(std::move(t)), 43);
+    EXPECT_TRUE(started);
+}
+
+TEST(TaskTest, DeepAwaitChainsComplete)
+{
+    // kept small enough for unoptimized builds, where the symmetric
+    // transfer is not a tail call
+    EXPECT_EQ(syncWait(sum(10000)), 50005000LL);
+}
+
+TEST(TaskTest, ExceptionsPropagateToTheAwaiter)
+{
+    auto outer = []() -> Task<std::string> {
+        try {
+            co_await fail();
+        }
+        catch (const std::runtime_error& e) {
+            co_return std::string("caught ") + e.what();
+        }
+        co_return "not thrown";
+    };
+    EXPECT_EQ(syncWait(outer()), "caught boom");
+    EXPECT_THROW(syncWait(fail()), std::runtime_error);
+}
+
+TEST(TaskTest, ScheduleResumesOnAPoolWorker)
+{
+    WorkerPool pool(2);
+    const auto caller = std::this_thread::get_id();
+    auto hop = [](WorkerPool& p) -> Task<std::thread::id> {
+        co_await schedule(p);
+        co_return std::this_thread::get_id();
+    };
+    EXPECT_NE(syncWait(hop(pool)), caller);
+}
+
+TEST(TaskTest, ThousandsOfSpawnedTasksComplete)
+{
+    WorkerPool pool(4);
+    std::atomic<int> done{0};
+    auto work = [](WorkerPool& p, std::atomic<int>& counter) -> Task<> {
+        co_await schedule(p);
+        const int v = co_await answer();
+        co_await schedule(p);
+        if (v == 42) {
+            counter.fetch_add(1);
+        }
+    };
+    const int n = 10000;
+    for (int i = 0; i < n; ++i) {
+        spawn(pool, work(pool, done));
+    }
+    pool.waitIdle();
+    EXPECT_EQ(done.load(), n);
+}
+
+TEST(TaskTest, AwaitsReadableAndWritableFds)
+{
+    EpollReactor reactor;
+    IoScheduler io(reactor);
+    Pipe pipe;
+    std::string received;
+    bool finished = false;
+    auto echo = [](IoScheduler& r, int in, int out, std::string& got,
+                   bool& flag) -> Task<> {
+        const IoEvent w = co_await writable(r, out);
+        EXPECT_TRUE(hasEvent(w, IoEvent::Writable));
+        EXPECT_EQ(::write(out, "ping", 4), 4);
+
+        const IoEvent ev = co_await readable(r, in);
+        EXPECT_TRUE(hasEvent(ev, IoEvent::Readable));
+        char buf[16];
+        const ssize_t n = ::read(in, buf, sizeof(buf));
+        got.assign(buf, n > 0 ? static_cast<size_t>(n) : 0);
+        flag = true;
+    };
+    spawn(echo(io, pipe.fds[0], pipe.fds[1], received, finished));
+    EXPECT_FALSE(finished); // suspended on the first await
+
+    for (int i = 0; i < 10 && !finished; ++i) {
+        reactor.poll(100);
+    }
+    EXPECT_TRUE(finished);
+    EXPECT_EQ(received, "ping");
+    // the fds were unregistered after each wake-up
+    EXPECT_NO_THROW(reactor.add(pipe.fds[0], IoEvent::Readable, nullptr));
+    reactor.remove(pipe.fds[0]);
+}
+
+TEST(TaskTest, AwaitsFdsFromPoolWorkersWhileTheReactorPolls)
+{
+    EpollReactor reactor;
+    IoScheduler io(reactor);
+    WorkerPool pool(2);
+    const int n = 50;
+    std::atomic<int> done{0};
+    std::vector<std::unique_ptr<Pipe>> pipes;
+    for (int i = 0; i < n; ++i) {
+        pipes.push_back(std::make_unique<Pipe>());
+    }
+    auto waiter = [](WorkerPool& p, IoScheduler& s, int fd,
+                     std::atomic<int>& counter) -> Task<> {
+        co_await schedule(p);
+        // registered from a worker while the reactor thread is in poll()
+        const IoEvent ev = co_await readable(s, fd);
+        EXPECT_TRUE(hasEvent(ev, IoEvent::Readable));
+        co_await schedule(p);
+        counter.fetch_add(1);
+    };
+
+    std::atomic<bool> stop{false};
+    std::thread loop([&]() {
+        while (!stop.load()) {
+            reactor.poll(10);
+        }
+    });
+    for (auto& pipe : pipes) {
+        spawn(pool, waiter(pool, io, pipe->fds[0], done));
+    }
+    for (auto& pipe : pipes) {
+        EXPECT_EQ(::write(pipe->fds[1], "x", 1), 1);
+    }
+    const auto t0 = std::chrono::steady_clock::now();
+    while (done.load() < n && std::chrono::steady_clock::now() - t0 < 5s) {
+        std::this_thread::sleep_for(1ms);
+    }
+    stop = true;
+    loop.join();
+    pool.waitIdle();
+    EXPECT_EQ(done.load(), n);
+}
+
+TEST(TaskTest, RefusedRegistrationThrowsAtTheAwait)
+{
+    EpollReactor reactor;
+    IoScheduler io(reactor);
+    Pipe pipe;
+    reactor.add(pipe.fds[0], IoEvent::Readable, nullptr);
+    bool threw = false;
+    auto twice = [](IoScheduler& s, int fd, bool& flag) -> Task<> {
+        try {
+            co_await readable(s, fd);
+        }
+        catch (const std::runtime_error&) {
+            flag = true;
+        }
+    };
+    spawn(twice(io, pipe.fds[0], threw));
+    reactor.poll(100);
+    EXPECT_TRUE(threw);
+    reactor.remove(pipe.fds[0]);
+}
+
+TEST(TaskTest, ReactorCallbackMayRemoveItself)
+{
+    EpollReactor reactor;
+    Pipe pipe;
+    auto token = std::make_shared<int>(7);
+    std::weak_ptr<int> watch = token;
+    int seen = 0;
+    reactor.add(pipe.fds[1], IoEvent::Writable,
+                [&reactor, &seen, token](int fd, IoEvent) {
+                    reactor.remove(fd);
+                    // still alive: the reactor holds it until we return
+                    seen = *token;
+                });
+    token.reset();
+    EXPECT_EQ(reactor.poll(100), 1);
+    EXPECT_EQ(seen, 7);
+    EXPECT_TRUE(watch.expired());
+    EXPECT_EQ(reactor.poll(0), 0);
+}
+
+TEST(TaskTest, SleepsOnTheTimerWheel)
+{
+    EpollReactor reactor;
+    TimerWheel timers(1ms);
+    timers.attach(reactor);
+    int step = 0;
+    const auto t0 = TimerWheel::Clock::now();
+    auto sleeper = [](TimerWheel& t, int& s) -> Task<> {
+        s = 1;
+        co_await sleepFor(t, 5ms);
+        s = 2;
+        co_await sleepFor(t, 5ms);
+        s = 3;
+    };
+    spawn(sleeper(timers, step));
+    EXPECT_EQ(step, 1);
+    while (step < 3 && TimerWheel::Clock::now() - t0 < 2s) {
+        reactor.poll(100);
+    }
+    EXPECT_EQ(step, 3);
+    EXPECT_GE(TimerWheel::Clock::now() - t0, 10ms);
+}
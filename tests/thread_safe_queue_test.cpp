@@ -1,7 +1,10 @@
 // thread_safe_queue_test.cpp
 #include "threading/thread_safe_queue.hpp"
+#include "network/impl/reactor/epoll_reactor.hpp"
+#include "threading/event_fd.hpp"
 #include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <gtest/gtest.h>
 #include <thread>
 #include <vector>
@@ -225,3 +228,224 @@ TEST(ThreadSafeQueueTest, PushBackExceptionDoesNotBreakFutureOperations)
     EXPECT_EQ(r1.value, 1);
     EXPECT_EQ(r2.value, 2);
 }
+
+// ----------------------
+// move-aware and batched operations
+// ----------------------
+
+struct CopyCounter
+{
+    static int copies;
+    std::vector<int> payload;
+
+    CopyCounter() = default;
+    explicit CopyCounter(std::vector<int> p) : payload(std::move(p)) {}
+    CopyCounter(const CopyCounter& other) : payload(other.payload)
+    {
+        ++copies;
+    }
+    CopyCounter(CopyCounter&&) noexcept = default;
+    CopyCounter& operator=(const CopyCounter&) = default;
+    CopyCounter& operator=(CopyCounter&&) noexcept = default;
+};
+
+int CopyCounter::copies = 0;
+
+TEST(ThreadSafeQueueTest, MovesElementsInAndOut)
+{
+    CopyCounter::copies = 0;
+    ThreadSafeQueue<CopyCounter> q;
+
+    CopyCounter big(std::vector<int>(1000, 7));
+    q.push_back(std::move(big));
+    q.emplace_back(std::vector<int>(10, 1));
+    q.push_front(CopyCounter(std::vector<int>(3, 2)));
+    q.emplace_front();
+
+    EXPECT_TRUE(q.pop_front().payload.empty());
+    EXPECT_EQ(q.pop_front().payload.size(), 3u);
+    EXPECT_EQ(q.pop_back_optional()->payload.size(), 10u);
+    EXPECT_EQ(q.pop_front_optional()->payload.size(), 1000u);
+    EXPECT_EQ(CopyCounter::copies, 0);
+}
+
+TEST(ThreadSafeQueueTest, PushBatchAndPopBatchTransferInOrder)
+{
+    ThreadSafeQueue<int> q;
+    std::vector<int> items{1, 2, 3, 4, 5};
+    q.push_batch(items);
+    q.push_batch(std::vector<int>{6, 7});
+
+    std::vector<int> out{0};
+    EXPECT_EQ(q.pop_batch(out, 4), 4u);
+    EXPECT_EQ(out, (std::vector<int>{0, 1, 2, 3, 4}));
+    EXPECT_EQ(q.pop_batch(out, 10), 3u);
+    EXPECT_EQ(out.back(), 7);
+    EXPECT_EQ(q.pop_batch(out, 0), 0u);
+
+    q.close();
+    EXPECT_EQ(q.pop_batch(out, 10), 0u);
+    EXPECT_THROW(q.push_batch(items), std::runtime_error);
+}
+
+TEST(ThreadSafeQueueTest, PushBatchMovesFromRvalueRange)
+{
+    CopyCounter::copies = 0;
+    ThreadSafeQueue<CopyCounter> q;
+    std::vector<CopyCounter> batch(8, CopyCounter(std::vector<int>(4, 1)));
+    CopyCounter::copies = 0;
+
+    q.push_batch(std::move(batch));
+    std::vector<CopyCounter> out;
+    EXPECT_EQ(q.pop_batch(out, 8), 8u);
+    EXPECT_EQ(CopyCounter::copies, 0);
+    EXPECT_EQ(out[7].payload.size(), 4u);
+}
+
+TEST(ThreadSafeQueueTest, FailedPushBatchLeavesQueueUnchanged)
+{
+    ThreadSafeQueue<ThrowOnCopy> q;
+    q.push_back(ThrowOnCopy(1));
+    std::vector<ThrowOnCopy> batch{ThrowOnCopy(2), ThrowOnCopy(3)};
+
+    ThrowOnCopy::throw_on_copy = true;
+    EXPECT_THROW(q.push_batch(batch), std::runtime_error);
+    ThrowOnCopy::throw_on_copy = false;
+
+    std::vector<ThrowOnCopy> out;
+    EXPECT_EQ(q.pop_batch(out, 10), 1u);
+    EXPECT_EQ(out[0].value, 1);
+}
+
+TEST(ThreadSafeQueueTest, PopBatchWakesForBatchFromAnotherThread)
+{
+    ThreadSafeQueue<int> q;
+    std::vector<int> out;
+    std::thread consumer([&] {
+        while (out.size() < 100) {
+            q.pop_batch(out, 32);
+        }
+    });
+
+    std::vector<int> batch(100);
+    for (int i = 0; i < 100; ++i) {
+        batch[static_cast<std::size_t>(i)] = i;
+    }
+    q.push_batch(batch);
+    consumer.join();
+    EXPECT_EQ(out, batch);
+}
+
+// ----------------------
+// non-blocking, timed pops and reactor integration
+// ----------------------
+
+TEST(ThreadSafeQueueTest, TryPopFrontNeverBlocks)
+{
+    ThreadSafeQueue<int> q;
+    EXPECT_FALSE(q.try_pop_front().has_value());
+    q.push_back(5);
+    EXPECT_EQ(q.try_pop_front(), 5);
+    EXPECT_FALSE(q.try_pop_front().has_value());
+}
+
+TEST(ThreadSafeQueueTest, TimedPopsReturnOnTimeoutOrArrival)
+{
+    using namespace std::chrono_literals;
+    ThreadSafeQueue<int> q;
+
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(q.pop_front_for(30ms).has_value());
+    EXPECT_GE(std::chrono::steady_clock::now() - start, 30ms);
+
+    std::thread producer([&] {
+        std::this_thread::sleep_for(20ms);
+        q.push_back(9);
+    });
+    EXPECT_EQ(q.pop_front_until(std::chrono::steady_clock::now() + 5s), 9);
+    producer.join();
+
+    q.close();
+    EXPECT_FALSE(q.pop_front_for(5s).has_value()) << "close must not wait";
+}
+
+TEST(ThreadSafeQueueTest, BlockingPopsWakeOnClose)
+{
+    ThreadSafeQueue<int> q;
+    std::atomic<int> threw{0};
+    std::thread a([&] {
+        try {
+            q.pop_front();
+        }
+        catch (const std::runtime_error&) {
+            ++threw;
+        }
+    });
+    std::thread b([&] {
+        try {
+            q.pop_back();
+        }
+        catch (const std::runtime_error&) {
+            ++threw;
+        }
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    q.close();
+    a.join();
+    b.join();
+    EXPECT_EQ(threw.load(), 2);
+}
+
+TEST(ThreadSafeQueueTest, OnPushHookFiresWhenQueueBecomesNonEmpty)
+{
+    ThreadSafeQueue<int> q;
+    int fired = 0;
+    q.set_on_push([&] {
+        ++fired;
+    });
+
+    q.push_back(1);
+    q.push_back(2); // already non-empty, no second wake-up
+    EXPECT_EQ(fired, 1);
+    q.try_pop_front();
+    q.try_pop_front();
+    q.push_batch(std::vector<int>{3, 4});
+    EXPECT_EQ(fired, 2);
+    q.close();
+    EXPECT_EQ(fired, 3);
+}
+
+TEST(ThreadSafeQueueTest, EpollReactorConsumesResultsThroughEventFd)
+{
+    ThreadSafeQueue<int> results;
+    EventFd ready;
+    results.set_on_push([&ready] {
+        ready.signal();
+    });
+
+    std::vector<int> consumed;
+    EpollReactor reactor;
+    reactor.add(ready.fd(), IoEvent::Readable, [&](int, IoEvent) {
+        ready.drain();
+        while (auto r = results.try_pop_front()) {
+            consumed.push_back(*r);
+        }
+    });
+
+    std::thread worker([&] {
+        for (int i = 0; i < 100; ++i) {
+            results.push_back(i);
+        }
+    });
+
+    for (int tick = 0; tick < 200 && consumed.size() < 100; ++tick) {
+        reactor.poll(50);
+    }
+    worker.join();
+
+    ASSERT_EQ(consumed.size(), 100u);
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(consumed[static_cast<std::size_t>(i)], i);
+    }
+    EXPECT_EQ(ready.drain(), 0u);
+}
@@ -1,8 +1,13 @@
 // thread_test.cpp
+#include "threading/cpu_topology.hpp"
 #include "threading/thread.hpp"
 #include <atomic>
 #include <chrono>
 #include <gtest/gtest.h>
+#include <pthread.h>
+#include <sched.h>
+#include <string>
+#include <system_error>
 #include <thread>
 
 TEST(ThreadTest, DoesNotRunFunctionBeforeStart)
@@ -77,3 +82,51 @@ TEST(ThreadTest, ThreadIsProperlyJoinedOnDestruction)
 
     EXPECT_TRUE(finished.load(std::memory_order_acquire));
 }
+
+TEST(ThreadTest, PinsToCpuSetAndNamesOsThread)
+{
+    const int cpu = CpuTopology::detect().cpus().front().id;
+    int pinnedCount = -1;
+    bool pinnedToCpu = false;
+    std::string osName;
+
+    Thread t("a_rather_long_thread_name",
+             [&]() {
+                 cpu_set_t set;
+                 CPU_ZERO(&set);
+                 pthread_getaffinity_np(pthread_self(), sizeof(set), &set);
+                 pinnedCount = CPU_COUNT(&set);
+                 pinnedToCpu = CPU_ISSET(cpu, &set);
+                 char name[16] = {};
+                 pthread_getname_np(pthread_self(), name, sizeof(name));
+                 osName = name;
+             },
+             Thread::Options{.cpus = {cpu}});
+    t.start();
+    t.stop();
+
+    EXPECT_EQ(pinnedCount, 1);
+    EXPECT_TRUE(pinnedToCpu);
+    EXPECT_EQ(osName, "a_rather_long_t");
+}
+
+TEST(ThreadTest, RejectedCpuSetThrowsFromStart)
+{
+    EXPECT_THROW(Thread("bad",
+                        []() {
+                        },
+                        Thread::Options{.cpus = {-1}}),
+                 std::invalid_argument);
+
+    // valid id, but not one this process may run on
+    std::atomic<bool> ran{false};
+    Thread t("outside",
+             [&]() {
+                 ran.store(true);
+             },
+             Thread::Options{.cpus = {CPU_SETSIZE - 1}});
+    if (CPU_SETSIZE - 1 > CpuTopology::detect().cpus().back().id) {
+        EXPECT_THROW(t.start(), std::system_error);
+        EXPECT_FALSE(ran.load());
+    }
+}
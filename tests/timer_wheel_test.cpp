@@ -0,0 +1,218 @@
+// tests/timer_wheel_test.cpp
+#include "network/impl/reactor/epoll_reactor.hpp"
+#include "threading/timer_wheel.hpp"
+#include "threading/worker_pool.hpp"
+#include <atomic>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using namespace std::chrono_literals;
+using Clock = TimerWheel::Clock;
+
+TEST(TimerWheelTest, OneShotFiresOnceNotEarly)
+{
+    TimerWheel wheel(1ms);
+    const auto t0 = Clock::now();
+    int fired = 0;
+    wheel.schedule(10ms, [&]() {
+        ++fired;
+    });
+    EXPECT_EQ(wheel.size(), 1u);
+
+    EXPECT_EQ(wheel.advance(t0 + 8ms), 0u);
+    EXPECT_EQ(fired, 0);
+    EXPECT_EQ(wheel.advance(t0 + 12ms), 1u);
+    EXPECT_EQ(fired, 1);
+    EXPECT_EQ(wheel.advance(t0 + 50ms), 0u);
+    EXPECT_EQ(fired, 1);
+    EXPECT_EQ(wheel.size(), 0u);
+    EXPECT_FALSE(wheel.nextTimeout());
+}
+
+TEST(TimerWheelTest, TimersCascadeFromCoarseWheels)
+{
+    TimerWheel wheel(1ms);
+    const auto t0 = Clock::now();
+    std::vector<int> order;
+    // wheel 2 (> 65536 ticks), wheel 1 and wheel 0
+    wheel.schedule(70s, [&]() {
+        order.push_back(3);
+    });
+    wheel.schedule(300ms, [&]() {
+        order.push_back(2);
+    });
+    wheel.schedule(5ms, [&]() {
+        order.push_back(1);
+    });
+
+    wheel.advance(t0 + 298ms);
+    EXPECT_EQ(order, (std::vector<int>{1}));
+    wheel.advance(t0 + 302ms);
+    EXPECT_EQ(order, (std::vector<int>{1, 2}));
+    wheel.advance(t0 + 69998ms);
+    EXPECT_EQ(order.size(), 2u);
+    wheel.advance(t0 + 70002ms);
+    EXPECT_EQ(order, (std::vector<int>{1, 2, 3}));
+}
+
+TEST(TimerWheelTest, ManyTimersFireOnceAndInTime)
+{
+    TimerWheel wheel(1ms);
+    const auto t0 = Clock::now();
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> delay(0, 3000);
+
+    const int n = 2000;
+    std::vector<int> wanted(n);
+    std::vector<int> firedAt(n, -1);
+    std::vector<int> fires(n, 0);
+    int now = 0;
+    for (int i = 0; i < n; ++i) {
+        wanted[i] = delay(rng);
+        wheel.schedule(std::chrono::milliseconds(wanted[i]), [&, i]() {
+            firedAt[i] = now;
+            ++fires[i];
+        });
+    }
+    // scheduling itself takes time: delays count from the schedule() call
+    const auto slack = std::chrono::ceil<std::chrono::milliseconds>(
+                           Clock::now() - t0)
+                           .count();
+    for (now = 0; now <= 3010 + slack; ++now) {
+        wheel.advance(t0 + std::chrono::milliseconds(now));
+    }
+    for (int i = 0; i < n; ++i) {
+        ASSERT_EQ(fires[i], 1) << i;
+        EXPECT_GE(firedAt[i], wanted[i]) << i;
+        EXPECT_LE(firedAt[i], wanted[i] + 2 + slack) << i;
+    }
+    EXPECT_EQ(wheel.size(), 0u);
+}
+
+TEST(TimerWheelTest, CancelIsExactAndStaleIdsAreIgnored)
+{
+    TimerWheel wheel(1ms);
+    const auto t0 = Clock::now();
+    int fired = 0;
+    auto a = wheel.schedule(10ms, [&]() {
+        ++fired;
+    });
+    EXPECT_TRUE(a.valid());
+    EXPECT_TRUE(wheel.cancel(a));
+    EXPECT_FALSE(wheel.cancel(a));
+    EXPECT_FALSE(wheel.cancel(TimerWheel::TimerId{}));
+
+    // b reuses a's node; a's id must not cancel it
+    auto b = wheel.schedule(10ms, [&]() {
+        ++fired;
+    });
+    EXPECT_EQ(b.index, a.index);
+    EXPECT_FALSE(wheel.cancel(a));
+    wheel.advance(t0 + 20ms);
+    EXPECT_EQ(fired, 1);
+    EXPECT_FALSE(wheel.cancel(b));
+
+    EXPECT_THROW(wheel.schedule(1ms, nullptr), std::invalid_argument);
+    EXPECT_THROW(wheel.scheduleEvery(0ms,
+                                     []() {
+                                     }),
+                 std::invalid_argument);
+}
+
+TEST(TimerWheelTest, PeriodicTimerKeepsItsPeriod)
+{
+    TimerWheel wheel(1ms);
+    const auto t0 = Clock::now();
+    int fired = 0;
+    auto id = wheel.scheduleEvery(10ms, [&]() {
+        ++fired;
+    });
+    for (int ms = 0; ms <= 36; ++ms) {
+        wheel.advance(t0 + std::chrono::milliseconds(ms));
+    }
+    EXPECT_EQ(fired, 3);
+    EXPECT_EQ(wheel.size(), 1u);
+    EXPECT_TRUE(wheel.cancel(id));
+    wheel.advance(t0 + 100ms);
+    EXPECT_EQ(fired, 3);
+}
+
+TEST(TimerWheelTest, ThrowingCallbackDoesNotDropOthers)
+{
+    TimerWheel wheel(1ms);
+    const auto t0 = Clock::now();
+    bool second = false;
+    wheel.schedule(1ms, []() {
+        throw std::runtime_error("boom");
+    });
+    wheel.schedule(1ms, [&]() {
+        second = true;
+    });
+    EXPECT_THROW(wheel.advance(t0 + 5ms), std::runtime_error);
+    EXPECT_TRUE(second);
+}
+
+TEST(TimerWheelTest, DispatchesOntoWorkerPool)
+{
+    WorkerPool pool(2);
+    TimerWheel wheel(pool, 1ms);
+    const auto t0 = Clock::now();
+    std::atomic<int> fired{0};
+    for (int i = 0; i < 10; ++i) {
+        wheel.schedule(std::chrono::milliseconds(i), [&]() {
+            fired.fetch_add(1);
+        });
+    }
+    EXPECT_EQ(wheel.advance(t0 + 20ms), 10u);
+    pool.waitIdle();
+    EXPECT_EQ(fired.load(), 10);
+}
+
+TEST(TimerWheelTest, StoppedPoolRunsCallbacksInline)
+{
+    WorkerPool pool(2);
+    TimerWheel wheel(pool, 1ms);
+    const auto t0 = Clock::now();
+    int fired = 0;
+    int ticks = 0;
+    for (int i = 0; i < 3; ++i) {
+        wheel.schedule(1ms, [&]() {
+            ++fired;
+        });
+    }
+    wheel.scheduleEvery(2ms, [&]() {
+        ++ticks;
+    });
+    pool.stop();
+    EXPECT_NO_THROW(wheel.advance(t0 + 5ms));
+    EXPECT_EQ(fired, 3);
+    EXPECT_EQ(ticks, 2);
+    EXPECT_EQ(wheel.size(), 1u); // the periodic timer is still armed
+}
+
+TEST(TimerWheelTest, DrivenByEpollReactorThroughTimerFd)
+{
+    EpollReactor reactor;
+    TimerWheel wheel(1ms);
+    wheel.attach(reactor);
+    EXPECT_THROW(wheel.attach(reactor), std::logic_error);
+
+    int fired = 0;
+    const auto t0 = Clock::now();
+    wheel.schedule(5ms, [&]() {
+        ++fired;
+    });
+    wheel.scheduleEvery(3ms, [&]() {
+        ++fired;
+    });
+    ASSERT_TRUE(wheel.nextTimeout());
+    while (fired < 4 && Clock::now() - t0 < 2s) {
+        reactor.poll(100);
+    }
+    EXPECT_GE(fired, 4);
+    EXPECT_GE(Clock::now() - t0, 5ms);
+    wheel.detach();
+}
@@ -0,0 +1,163 @@
+// tests/work_stealing_test.cpp
+#include "threading/work_stealing_deque.hpp"
+#include "threading/worker_pool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <gtest/gtest.h>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+TEST(WorkStealingDequeTest, OwnerPopsNewestThievesStealOldest)
+{
+    WorkStealingDeque<int> d(4);
+    for (int i = 0; i < 5; ++i) {
+        d.push(i);
+    }
+    EXPECT_EQ(d.size_approx(), 5u);
+    EXPECT_EQ(d.steal(), 0);
+    EXPECT_EQ(d.pop(), 4);
+    EXPECT_EQ(d.steal(), 1);
+    EXPECT_EQ(d.pop(), 3);
+    EXPECT_EQ(d.pop(), 2);
+    EXPECT_FALSE(d.pop().has_value());
+    EXPECT_FALSE(d.steal().has_value());
+    EXPECT_TRUE(d.empty());
+}
+
+TEST(WorkStealingDequeTest, GrowsPastInitialCapacity)
+{
+    WorkStealingDeque<int> d(2);
+    for (int i = 0; i < 1000; ++i) {
+        d.push(i);
+    }
+    for (int i = 999; i >= 0; --i) {
+        ASSERT_EQ(d.pop(), i);
+    }
+}
+
+TEST(WorkStealingDequeTest, EveryElementTakenExactlyOnceUnderContention)
+{
+    const int n = 20000;
+    WorkStealingDeque<int> d(16);
+    std::vector<std::atomic<int>> seen(n);
+    std::atomic<bool> ownerDone{false};
+
+    std::vector<std::thread> thieves;
+    for (int t = 0; t < 3; ++t) {
+        thieves.emplace_back([&]() {
+            while (!ownerDone.load() || !d.empty()) {
+                if (auto v = d.steal()) {
+                    seen[static_cast<std::size_t>(*v)].fetch_add(1);
+                }
+                else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (int i = 0; i < n; ++i) {
+        d.push(i);
+        if (i % 3 == 0) {
+            if (auto v = d.pop()) {
+                seen[static_cast<std::size_t>(*v)].fetch_add(1);
+            }
+        }
+    }
+    while (auto v = d.pop()) {
+        seen[static_cast<std::size_t>(*v)].fetch_add(1);
+    }
+    ownerDone = true;
+    for (auto& t : thieves) {
+        t.join();
+    }
+    for (int i = 0; i < n; ++i) {
+        ASSERT_EQ(seen[static_cast<std::size_t>(i)].load(), 1) << i;
+    }
+}
+
+TEST(WorkerPoolStealingTest, JobsSpawnedByJobsAllRun)
+{
+    std::atomic<int> leaves{0};
+    // declared before the pool so it outlives the jobs that use it
+    std::function<void(int)> spawn;
+    {
+        WorkerPool pool(
+            WorkerPool::Options{.workers = 4, .workStealing = true});
+
+        // binary fan-out, depth 10: 1024 leaves pushed to local deques
+        spawn = [&](int depth) {
+            if (depth == 0) {
+                leaves.fetch_add(1);
+                return;
+            }
+            pool.addJob([&spawn, depth]() {
+                spawn(depth - 1);
+            });
+            pool.addJob([&spawn, depth]() {
+                spawn(depth - 1);
+            });
+        };
+        pool.addJob([&]() {
+            spawn(10);
+        });
+
+        auto deadline =
+            std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (leaves.load() < 1024
+               && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    EXPECT_EQ(leaves.load(), 1024);
+}
+
+TEST(WorkerPoolStealingTest, IdleWorkersStealFromBusyOne)
+{
+    std::atomic<int> done{0};
+    std::mutex m;
+    std::vector<std::thread::id> ids;
+    {
+        WorkerPool pool(
+            WorkerPool::Options{.workers = 4, .workStealing = true});
+        pool.addJob([&]() {
+            // everything lands in this worker's deque while it keeps busy
+            for (int i = 0; i < 64; ++i) {
+                pool.addJob([&]() {
+                    {
+                        std::lock_guard<std::mutex> lock(m);
+                        ids.push_back(std::this_thread::get_id());
+                    }
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                    done.fetch_add(1);
+                });
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        });
+        while (done.load() < 64) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        std::sort(ids.begin(), ids.end());
+        ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+        EXPECT_GT(ids.size(), 1u) << "no job was stolen";
+    }
+    EXPECT_EQ(done.load(), 64);
+}
+
+TEST(WorkerPoolStealingTest, ExternalJobsGoThroughInjectorAndStopDrains)
+{
+    std::atomic<int> counter{0};
+    {
+        WorkerPool pool(WorkerPool::Options{.workers = 2,
+                                            .queueCapacity = 16,
+                                            .workStealing = true});
+        for (int i = 0; i < 500; ++i) {
+            pool.addJob([&]() {
+                counter.fetch_add(1);
+            });
+        }
+    }
+    EXPECT_EQ(counter.load(), 500);
+}
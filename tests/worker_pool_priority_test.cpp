@@ -0,0 +1,170 @@
+// tests/worker_pool_priority_test.cpp
+#include "threading/worker_pool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+// occupies the only worker until open() so jobs pile up in the lanes
+class Gate
+{
+public:
+    explicit Gate(WorkerPool& pool)
+    {
+        pool.addJob([this]() {
+            started_.store(true);
+            while (!open_.load()) {
+                std::this_thread::yield();
+            }
+        });
+        while (!started_.load()) {
+            std::this_thread::yield();
+        }
+    }
+
+    void open() { open_.store(true); }
+
+private:
+    std::atomic<bool> started_{false};
+    std::atomic<bool> open_{false};
+};
+
+class Recorder
+{
+public:
+    auto record(int v)
+    {
+        return [this, v]() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            order_.push_back(v);
+        };
+    }
+
+    std::vector<int> order()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return order_;
+    }
+
+private:
+    std::mutex mutex_;
+    std::vector<int> order_;
+};
+
+} // namespace
+
+TEST(WorkerPoolPriorityTest, LanesRunInPriorityOrder)
+{
+    WorkerPool pool(WorkerPool::Options{.workers = 1, .starvationLimit = 0});
+    Recorder rec;
+    Gate gate(pool);
+
+    const auto now = WorkerPool::Clock::now();
+    pool.addJob(WorkerPool::Priority::Background, rec.record(5));
+    pool.addJob(rec.record(4));
+    pool.addJob(now + std::chrono::seconds(2), rec.record(3));
+    pool.addJob(now + std::chrono::seconds(1), rec.record(2));
+    pool.addJob(WorkerPool::Priority::High, rec.record(0));
+    pool.addJob(WorkerPool::Priority::High, rec.record(1));
+    gate.open();
+    pool.waitIdle();
+
+    EXPECT_EQ(rec.order(), (std::vector<int>{0, 1, 2, 3, 4, 5}));
+}
+
+TEST(WorkerPoolPriorityTest, EqualDeadlinesKeepSubmissionOrder)
+{
+    WorkerPool pool(WorkerPool::Options{.workers = 1, .starvationLimit = 0});
+    Recorder rec;
+    Gate gate(pool);
+
+    const auto deadline = WorkerPool::Clock::now();
+    for (int i = 0; i < 8; ++i) {
+        pool.addJob(deadline, rec.record(i));
+    }
+    gate.open();
+    pool.waitIdle();
+
+    EXPECT_EQ(rec.order(), (std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7}));
+}
+
+TEST(WorkerPoolPriorityTest, BackgroundIsNotStarved)
+{
+    WorkerPool pool(WorkerPool::Options{.workers = 1, .starvationLimit = 4});
+    Recorder rec;
+    Gate gate(pool);
+
+    pool.addJob(WorkerPool::Priority::Background, rec.record(-1));
+    for (int i = 0; i < 20; ++i) {
+        pool.addJob(WorkerPool::Priority::High, rec.record(i));
+    }
+    gate.open();
+    pool.waitIdle();
+
+    auto order = rec.order();
+    ASSERT_EQ(order.size(), 21u);
+    auto pos = std::find(order.begin(), order.end(), -1) - order.begin();
+    EXPECT_LT(pos, 4);
+}
+
+TEST(WorkerPoolPriorityTest, SubmitWithPriorityAndStop)
+{
+    WorkerPool pool(2);
+    auto f = pool.submit(
+        WorkerPool::Priority::High,
+        [](int x) {
+            return x + 1;
+        },
+        41);
+    EXPECT_EQ(f.get(), 42);
+
+    pool.stop();
+    EXPECT_THROW(pool.addJob(WorkerPool::Priority::Background,
+                             []() {
+                             }),
+                 std::runtime_error);
+    EXPECT_THROW(pool.addJob(WorkerPool::Clock::now(),
+                             []() {
+                             }),
+                 std::runtime_error);
+}
+
+TEST(WorkerPoolPriorityTest, JobsAcceptedWhileStoppingStillRun)
+{
+    for (int round = 0; round < 20; ++round) {
+        WorkerPool pool(2);
+        std::atomic<int> accepted{0};
+        std::atomic<int> ran{0};
+
+        std::vector<std::thread> producers;
+        for (auto priority : {WorkerPool::Priority::High,
+                              WorkerPool::Priority::Normal,
+                              WorkerPool::Priority::Background}) {
+            producers.emplace_back([&, priority]() {
+                try {
+                    for (;;) {
+                        pool.addJob(priority, [&]() {
+                            ran.fetch_add(1);
+                        });
+                        accepted.fetch_add(1);
+                    }
+                }
+                catch (const std::runtime_error&) {
+                }
+            });
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        pool.stop();
+        for (auto& t : producers) {
+            t.join();
+        }
+        pool.waitIdle(); // nothing left pending once stop() returned
+        ASSERT_EQ(ran.load(), accepted.load()) << "round " << round;
+    }
+}